@@ -0,0 +1,202 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootstepMassProcessor.h"
+#include "FootstepMassFragments.h"
+#include "FootstepPoolingManager.h"
+#include "FootstepComponent.h"
+#include "FootstepDataAsset.h"
+#include "FootstepScalability.h"
+#include "FootstepTypes.h"
+#include "SurfaceFootstepSystemSettings.h"
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "MassMovementFragments.h"
+#include "Engine/World.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Async/ParallelFor.h"
+
+static constexpr int32 FootstepMassMinBatchSize = 16;
+
+UFootstepMassProcessor::UFootstepMassProcessor()
+	: EntityQuery(*this)
+{
+	// Footsteps are cosmetic. Listen servers need them too, a Dedicated Server has no Pooling Manager, so Execute returns right away there
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::Client | EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Server);
+	ExecutionOrder.ExecuteAfter.Add(UE::Mass::ProcessorGroupNames::Movement);
+	bRequiresGameThreadExecution = true;
+}
+
+void UFootstepMassProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FFootstepMassFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FFootstepMassParameters>();
+}
+
+void UFootstepMassProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UWorld* World = EntityManager.GetWorld();
+	UFootstepPoolingManager* PoolingManager = World ? World->GetSubsystem<UFootstepPoolingManager>() : nullptr;
+
+	if (!PoolingManager) { return; }
+
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepBatch);
+	LLM_SCOPE_BYTAG(Footstep);
+
+	// CVars can only be read on the game thread
+	const double TimeSeconds = World->GetTimeSeconds();
+	const float CullDistance = FootstepScalability::GetCullDistance();
+
+	PendingSteps.Reset();
+
+	EntityQuery.ForEachEntityChunk(Context, [this, TimeSeconds, CullDistance, PoolingManager](FMassExecutionContext& ChunkContext)
+	{
+		GatherSteps(ChunkContext, TimeSeconds, CullDistance, *PoolingManager);
+	});
+
+	if (PendingSteps.Num() == 0) { return; }
+
+	TraceSurfaces(*World);
+	GenerateFootsteps(*PoolingManager);
+}
+
+void UFootstepMassProcessor::GatherSteps(FMassExecutionContext& Context, double TimeSeconds, float CullDistance, const UFootstepPoolingManager& PoolingManager)
+{
+	// All agents of a chunk share their gait and Footstep Data Assets
+	const FFootstepMassParameters& Parameters = Context.GetConstSharedFragment<FFootstepMassParameters>();
+	const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+	const TConstArrayView<FMassVelocityFragment> Velocities = Context.GetFragmentView<FMassVelocityFragment>();
+	const TArrayView<FFootstepMassFragment> Footsteps = Context.GetMutableFragmentView<FFootstepMassFragment>();
+
+	const double MinSpeedSquared = FMath::Square(static_cast<double>(Parameters.MinSpeed));
+	const double SurfaceCacheDistanceSquared = FMath::Square(static_cast<double>(Parameters.SurfaceCacheDistance));
+	const double MinStepInterval = 1.0 / Parameters.MaxCadence;
+
+	for (int32 EntityIndex = 0; EntityIndex < Context.GetNumEntities(); ++EntityIndex)
+	{
+		FFootstepMassFragment& Footstep = Footsteps[EntityIndex];
+		const FVector& Velocity = Velocities[EntityIndex].Value;
+		const double SpeedSquared = Velocity.SizeSquared2D();
+
+		if (SpeedSquared < MinSpeedSquared || SpeedSquared <= UE_SMALL_NUMBER)
+		{
+			Footstep.NextStepTime = 0.0;
+			continue;
+		}
+
+		const double StepInterval = FMath::Max(Parameters.StepLength / FMath::Sqrt(SpeedSquared), MinStepInterval);
+
+		// Agents which start walking together shouldn't step in unison
+		if (Footstep.NextStepTime <= 0.0)
+		{
+			Footstep.NextStepTime = TimeSeconds + (StepInterval * FMath::FRand());
+			continue;
+		}
+
+		if (TimeSeconds < Footstep.NextStepTime) { continue; }
+
+		Footstep.NextStepTime = TimeSeconds + StepInterval;
+		Footstep.bLeftFoot = !Footstep.bLeftFoot;
+
+		const FTransform& Transform = Transforms[EntityIndex].GetTransform();
+		const FVector Forward = Velocity.GetSafeNormal2D();
+		const FVector Right = FVector::CrossProduct(FVector::UpVector, Forward);
+		const FVector FootLocation = Transform.GetLocation() + (Right * (Footstep.bLeftFoot ? -0.5f : 0.5f) * Parameters.FootSpacing);
+
+		if (!PoolingManager.IsInCullDistance(FootLocation, CullDistance)) { continue; }
+
+		FFootstepMassStep& Step = PendingSteps.AddDefaulted_GetRef();
+		Step.Fragment = &Footstep;
+		Step.Parameters = &Parameters;
+		Step.FootLocation = FootLocation;
+		Step.Forward = Forward;
+		Step.bTrace = !Footstep.bHasSurface || FVector::DistSquared2D(Footstep.SurfaceLocation, FootLocation) > SurfaceCacheDistanceSquared;
+	}
+}
+
+void UFootstepMassProcessor::TraceSurfaces(const UWorld& World)
+{
+	const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+
+	if (!FootstepSettings) { return; }
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FootstepMass), FootstepSettings->GetTraceComplex());
+	QueryParams.bReturnPhysicalMaterial = true;
+
+	FCollisionObjectQueryParams ObjectParams;
+	for (const ECollisionChannel ObjectType : FootstepSettings->GetFootstepObjectTypes())
+	{
+		ObjectParams.AddObjectTypesToQuery(ObjectType);
+	}
+
+	// Every step writes only to its own agent, which steps at most once per frame
+	ParallelFor(TEXT("Footstep.Mass.Trace"), PendingSteps.Num(), FootstepMassMinBatchSize, [this, &World, &QueryParams, &ObjectParams](int32 Index)
+	{
+		const FFootstepMassStep& Step = PendingSteps[Index];
+
+		if (!Step.bTrace) { return; }
+
+		const FVector TraceStart = Step.FootLocation + (FVector::UpVector * Step.Parameters->TraceHeight);
+		const FVector TraceEnd = TraceStart - (FVector::UpVector * Step.Parameters->TraceLength);
+
+		FHitResult HitResult;
+		bool bHit = false;
+		{
+			FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepTrace);
+			bHit = World.LineTraceSingleByObjectType(HitResult, TraceStart, TraceEnd, ObjectParams, QueryParams) && HitResult.bBlockingHit;
+		}
+
+		const UPhysicalMaterial* PhysMat = bHit ? UFootstepComponent::GetHitPhysicalMaterial(HitResult) : nullptr;
+
+		FFootstepMassFragment& Footstep = *Step.Fragment;
+		Footstep.bHasSurface = PhysMat != nullptr;
+		Footstep.SurfaceLocation = bHit ? HitResult.ImpactPoint : Step.FootLocation;
+		Footstep.SurfaceNormal = bHit ? HitResult.ImpactNormal : FVector::UpVector;
+		Footstep.SurfaceType = PhysMat ? PhysMat->SurfaceType : SurfaceType_Default;
+	});
+}
+
+void UFootstepMassProcessor::GenerateFootsteps(UFootstepPoolingManager& PoolingManager)
+{
+	// Every footstep has its own random stream, like in the Footstep Batch Manager
+	const uint32 BatchSeed = static_cast<uint32>(GFrameCounter);
+
+	for (int32 Index = 0; Index < PendingSteps.Num(); ++Index)
+	{
+		const FFootstepMassStep& Step = PendingSteps[Index];
+		const FFootstepMassFragment& Footstep = *Step.Fragment;
+
+		if (!Footstep.bHasSurface) { continue; }
+
+		// The per frame budget is shared with Footstep Components
+		constexpr bool bInCullDistance = true;
+		if (!PoolingManager.ApplyFootstepBudget(bInCullDistance)) { continue; }
+
+		const TSoftObjectPtr<UFootstepDataAsset>* DataAssetPtr = Step.Parameters->FootstepFXes.Find(Footstep.SurfaceType);
+		const UFootstepDataAsset* FootstepData = DataAssetPtr ? FootstepAsset::LoadSynchronous(*DataAssetPtr) : nullptr;
+
+		if (!FootstepData) { continue; }
+
+		INC_DWORD_STAT(STAT_FootstepCount);
+		CSV_CUSTOM_STAT(Footstep, Footsteps, 1, ECsvCustomStatOp::Accumulate);
+
+		// A cached surface is assumed to be a plane, so footsteps follow slopes without tracing
+		const FVector Location = FVector::PointPlaneProject(Step.FootLocation, Footstep.SurfaceLocation, Footstep.SurfaceNormal);
+		const FGameplayTag& FootstepCategory = Step.Parameters->FootstepCategory;
+
+		FRandomStream RandomStream(static_cast<int32>(HashCombine(BatchSeed, static_cast<uint32>(Index))));
+		const FFootstepVariation Variation = FootstepData->SelectVariation(FootstepCategory, RandomStream);
+
+		// Agents have no actor which would tell whether they were rendered, so only the view distance chooses LOD tiers
+		FFootstepFXParams FXParams;
+		FXParams.Location = Location;
+		FXParams.Normal = Footstep.SurfaceNormal;
+		FXParams.Forward = Step.Forward;
+		FXParams.Variation = &Variation;
+
+		FFootstepFXResult FXResult;
+		PoolingManager.GenerateFootstepFX(*FootstepData, FootstepCategory, FXParams, FXResult);
+	}
+}
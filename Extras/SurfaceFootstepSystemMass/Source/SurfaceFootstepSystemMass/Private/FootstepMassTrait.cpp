@@ -0,0 +1,21 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootstepMassTrait.h"
+#include "MassEntityTemplateRegistry.h"
+#include "MassEntityUtils.h"
+#include "MassCommonFragments.h"
+#include "MassMovementFragments.h"
+#include "Engine/World.h"
+
+void UFootstepMassTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+	FMassEntityManager& EntityManager = UE::Mass::Utils::GetEntityManagerChecked(World);
+
+	BuildContext.RequireFragment<FTransformFragment>();
+	BuildContext.RequireFragment<FMassVelocityFragment>();
+	BuildContext.AddFragment<FFootstepMassFragment>();
+
+	// Agents with the same parameters share one fragment, so they end up in the same chunks
+	const FConstSharedStruct ParametersFragment = EntityManager.GetOrCreateConstSharedFragment(Footsteps);
+	BuildContext.AddConstSharedFragment(ParametersFragment);
+}
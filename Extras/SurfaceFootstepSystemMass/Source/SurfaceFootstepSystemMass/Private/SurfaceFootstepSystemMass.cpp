@@ -0,0 +1,5 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, SurfaceFootstepSystemMass)
@@ -0,0 +1,74 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "GameplayTagContainer.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "FootstepMassFragments.generated.h"
+
+class UFootstepDataAsset;
+
+/**
+ * Gait of a Mass agent and the Footstep Data Assets it uses. Shared by all agents created from the same Footstep Mass Trait.
+ */
+USTRUCT()
+struct SURFACEFOOTSTEPSYSTEMMASS_API FFootstepMassParameters : public FMassConstSharedFragment
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Footstep Data Assets used on the given Surface Types, like in the Footstep Component. */
+	UPROPERTY(EditAnywhere, Category = "Footstep")
+	TMap<TEnumAsByte<EPhysicalSurface>, TSoftObjectPtr<UFootstepDataAsset>> FootstepFXes;
+
+	UPROPERTY(EditAnywhere, Category = "Footstep", meta = (Categories = "Footstep"))
+	FGameplayTag FootstepCategory;
+
+	/** Distance covered by one step. The step interval is the step length divided by the agent's speed. */
+	UPROPERTY(EditAnywhere, Category = "Footstep|Gait", meta = (ClampMin = "1.0", UIMin = "1.0", ForceUnits = "cm"))
+	float StepLength = 70.f;
+
+	/** The highest amount of steps per second, reached when running. */
+	UPROPERTY(EditAnywhere, Category = "Footstep|Gait", meta = (ClampMin = "0.1", UIMin = "0.1"))
+	float MaxCadence = 3.5f;
+
+	/** Agents slower than this don't generate footsteps. */
+	UPROPERTY(EditAnywhere, Category = "Footstep|Gait", meta = (ClampMin = "0.0", UIMin = "0.0", ForceUnits = "cm/s"))
+	float MinSpeed = 20.f;
+
+	/** Lateral distance between the left and the right foot. */
+	UPROPERTY(EditAnywhere, Category = "Footstep|Gait", meta = (ClampMin = "0.0", UIMin = "0.0", ForceUnits = "cm"))
+	float FootSpacing = 20.f;
+
+	/** Height above the agent's location from which the surface is traced. */
+	UPROPERTY(EditAnywhere, Category = "Footstep|Trace", meta = (ClampMin = "0.0", UIMin = "0.0", ForceUnits = "cm"))
+	float TraceHeight = 50.f;
+
+	UPROPERTY(EditAnywhere, Category = "Footstep|Trace", meta = (ClampMin = "0.0", UIMin = "0.0", ForceUnits = "cm"))
+	float TraceLength = 150.f;
+
+	/** The surface under an agent is traced again only after it has moved this far, so most footsteps of a walking crowd don't trace at all. 0 traces every footstep. */
+	UPROPERTY(EditAnywhere, Category = "Footstep|Trace", meta = (ClampMin = "0.0", UIMin = "0.0", ForceUnits = "cm"))
+	float SurfaceCacheDistance = 150.f;
+};
+
+/**
+ * Per agent state of the Footstep Mass Processor.
+ */
+USTRUCT()
+struct SURFACEFOOTSTEPSYSTEMMASS_API FFootstepMassFragment : public FMassFragment
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** World time of the next footstep, or 0 if the agent is standing. */
+	double NextStepTime = 0.0;
+
+	/** Location of the last surface trace and its results. */
+	FVector SurfaceLocation = FVector::ZeroVector;
+	FVector SurfaceNormal = FVector::UpVector;
+	TEnumAsByte<EPhysicalSurface> SurfaceType = SurfaceType_Default;
+
+	bool bHasSurface = false;
+	bool bLeftFoot = false;
+};
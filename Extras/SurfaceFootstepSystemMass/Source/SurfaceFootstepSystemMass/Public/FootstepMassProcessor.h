@@ -0,0 +1,52 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "FootstepMassProcessor.generated.h"
+
+class UFootstepPoolingManager;
+struct FFootstepMassFragment;
+struct FFootstepMassParameters;
+
+/** A footstep of a Mass agent which is due this frame, together with the results of its parallel trace. */
+struct FFootstepMassStep
+{
+	FFootstepMassFragment* Fragment = nullptr;
+	const FFootstepMassParameters* Parameters = nullptr;
+	FVector FootLocation = FVector::ZeroVector;
+	FVector Forward = FVector::ForwardVector;
+	bool bTrace = false;
+};
+
+/**
+ * Generates footsteps of agents with the Footstep Mass Trait.
+ * Footsteps are gathered chunk by chunk, their surfaces are traced in parallel and only when an agent has left its cached surface,
+ * and the FX are handed to the Footstep Pooling Manager, which applies the same culling, budget and LOD tiers as to Footstep Components.
+ */
+UCLASS()
+class SURFACEFOOTSTEPSYSTEMMASS_API UFootstepMassProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UFootstepMassProcessor();
+
+protected:
+	//~ Begin UMassProcessor Interface
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	//~ End UMassProcessor Interface
+
+private:
+	FMassEntityQuery EntityQuery;
+
+	/** Footsteps of the current frame. Keeps its allocation between frames. */
+	TArray<FFootstepMassStep> PendingSteps;
+
+	void GatherSteps(FMassExecutionContext& Context, double TimeSeconds, float CullDistance, const UFootstepPoolingManager& PoolingManager);
+	void TraceSurfaces(const UWorld& World);
+	void GenerateFootsteps(UFootstepPoolingManager& PoolingManager);
+};
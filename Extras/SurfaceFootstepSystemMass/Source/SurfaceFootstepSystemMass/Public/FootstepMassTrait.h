@@ -0,0 +1,26 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTraitBase.h"
+#include "FootstepMassFragments.h"
+#include "FootstepMassTrait.generated.h"
+
+/**
+ * Generates footsteps for Mass agents without a skeletal mesh, e.g. crowds rendered with vertex animated Instanced Static Meshes.
+ * Footstep timing is derived from the agent's velocity and gait, so no Anim Notifies are needed.
+ */
+UCLASS(meta = (DisplayName = "Surface Footsteps"))
+class SURFACEFOOTSTEPSYSTEMMASS_API UFootstepMassTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+	//~ Begin UMassEntityTraitBase Interface
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+	//~ End UMassEntityTraitBase Interface
+
+	UPROPERTY(EditAnywhere, Category = "Footstep")
+	FFootstepMassParameters Footsteps;
+};
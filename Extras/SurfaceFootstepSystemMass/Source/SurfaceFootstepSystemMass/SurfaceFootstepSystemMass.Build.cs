@@ -0,0 +1,36 @@
+// Copyright 1998-2020 Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class SurfaceFootstepSystemMass : ModuleRules
+{
+	public SurfaceFootstepSystemMass(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		bLegacyPublicIncludePaths = false;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"GameplayTags",
+				"PhysicsCore",
+				"MassEntity",
+				"MassSpawner",
+				"SurfaceFootstepSystem"
+			}
+			);
+
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"MassCommon",
+				"MassMovement"
+			}
+			);
+	}
+}
@@ -0,0 +1,111 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "AnimNotifyState_SurfaceFootstep.h"
+#include "FootstepComponent.h"
+#include "SurfaceFootstepSystemSettings.h"
+#include "FootstepTypes.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimSequenceBase.h"
+#include "GameFramework/Actor.h"
+
+UAnimNotifyState_SurfaceFootstep::UAnimNotifyState_SurfaceFootstep(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+#if WITH_EDITORONLY_DATA
+	NotifyColor = FColor(0, 188, 0, 255);
+#endif
+
+	FootstepSettings = USurfaceFootstepSystemSettings::Get();
+
+	if (FootstepSettings)
+	{
+		FootstepCategory = FootstepSettings->GetCategoriesNum() > 0 ? FootstepSettings->GetCategoryName(0) : FGameplayTag::EmptyTag;
+	}
+}
+
+void UAnimNotifyState_SurfaceFootstep::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyBegin(MeshComp, Animation, TotalDuration, EventReference);
+
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepNotify);
+	LLM_SCOPE_BYTAG(Footstep);
+
+	if (!FootstepSettings) { return; }
+
+	UFootstepComponent* FootstepComponent = UAnimNotify_SurfaceFootstep::FindFootstepComponent(MeshComp, FootstepCategory);
+	if (!FootstepComponent) { return; }
+
+	if (UAnimNotify_SurfaceFootstep::GetNotifyWeight(MeshComp, EventReference) < FootstepSettings->GetMinNotifyWeight()) { return; }
+
+	FFootstepRequest Request = UAnimNotify_SurfaceFootstep::MakeFootstepRequest(MeshComp, Animation, FootstepCategory, FootstepTraceDirection, TraceFromFootSocket() ? FootSocket : NAME_None);
+
+	// The duration is measured on the notify timeline, which is close enough to predict where the foot lands
+	float TimeToContact = TotalDuration;
+	const float RateScale = Animation ? FMath::Abs(Animation->RateScale) : 1.f;
+	if (RateScale > UE_KINDA_SMALL_NUMBER)
+	{
+		TimeToContact /= RateScale;
+	}
+
+	// The foot lands where the character will be at the end of the state
+	Request.TraceStart += MeshComp->GetOwner()->GetVelocity() * TimeToContact;
+
+	FootstepComponent->PrepareFootstep(Request);
+}
+
+void UAnimNotifyState_SurfaceFootstep::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyEnd(MeshComp, Animation, EventReference);
+
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepNotify);
+	LLM_SCOPE_BYTAG(Footstep);
+	FOOTSTEP_ALLOCATION_GUARD_SCOPE(TEXT("UAnimNotifyState_SurfaceFootstep::NotifyEnd"));
+
+	if (!FootstepSettings) { return; }
+
+	UFootstepComponent* FootstepComponent = UAnimNotify_SurfaceFootstep::FindFootstepComponent(MeshComp, FootstepCategory);
+	if (!FootstepComponent) { return; }
+
+	// A state which blends out, is stopped or jumped over ends before its contact frame
+	if (!HasReachedEnd(Animation, EventReference))
+	{
+		FootstepComponent->CancelPreparedFootstep(TraceFromFootSocket() ? FootSocket : NAME_None);
+		return;
+	}
+
+	const float NotifyWeight = UAnimNotify_SurfaceFootstep::GetNotifyWeight(MeshComp, EventReference);
+	if (NotifyWeight < FootstepSettings->GetMinNotifyWeight()) { return; }
+
+	FFootstepRequest Request = UAnimNotify_SurfaceFootstep::MakeFootstepRequest(MeshComp, Animation, FootstepCategory, FootstepTraceDirection, TraceFromFootSocket() ? FootSocket : NAME_None);
+	Request.Weight = NotifyWeight;
+	UAnimNotify_SurfaceFootstep::SetThrottling(Request, MeshComp, Animation, EventReference);
+
+	FootstepComponent->RequestPreparedFootstep(Request);
+}
+
+FString UAnimNotifyState_SurfaceFootstep::GetNotifyName_Implementation() const
+{
+	return TraceFromFootSocket() ? Super::GetNotifyName_Implementation() + TEXT("_") + FootSocket.ToString() : Super::GetNotifyName_Implementation();
+}
+
+bool UAnimNotifyState_SurfaceFootstep::HasReachedEnd(const UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	const FAnimNotifyEvent* NotifyEvent = EventReference.GetNotify();
+
+	// Reversed playback ends the state at its beginning, so only forward playback is checked
+	if (!(NotifyEvent && Animation && Animation->RateScale > 0.f)) { return true; }
+
+	// Measured on the notify timeline, so play rates and the lateness of the notifies don't matter
+	const float CurrentTime = EventReference.GetCurrentAnimationTime();
+	const bool bPastEnd = CurrentTime >= NotifyEvent->GetEndTriggerTime() - UE_KINDA_SMALL_NUMBER;
+
+	// The animation may have looped past the end of the state
+	const bool bLooped = CurrentTime < NotifyEvent->GetTriggerTime();
+
+	return bPastEnd || bLooped;
+}
+
+bool UAnimNotifyState_SurfaceFootstep::TraceFromFootSocket() const
+{
+	return bTraceFromFootSocket && FootSocket != NAME_None;
+}
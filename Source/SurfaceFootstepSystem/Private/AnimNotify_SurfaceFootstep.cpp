@@ -3,14 +3,14 @@
 #include "AnimNotify_SurfaceFootstep.h"
 #include "FootstepInterface.h"
 #include "FootstepComponent.h"
-#include "FootstepActor.h"
-#include "FootstepDataAsset.h"
 #include "SurfaceFootstepSystemSettings.h"
-#include "FootstepPoolingManager.h"
 #include "FootstepTypes.h"
 #include "Engine.h"
-#include "PhysicalMaterials/PhysicalMaterial.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimNotifyQueue.h"
 #include "Logging/MessageLog.h"
 
 #define LOCTEXT_NAMESPACE "FAnimNotify_SurfaceFootstep"
@@ -34,26 +34,45 @@ void UAnimNotify_SurfaceFootstep::Notify(USkeletalMeshComponent* MeshComp, UAnim
 {
 	Super::Notify(MeshComp, Animation, EventReference);
 
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepNotify);
+	LLM_SCOPE_BYTAG(Footstep);
+	FOOTSTEP_ALLOCATION_GUARD_SCOPE(TEXT("UAnimNotify_SurfaceFootstep::Notify"));
+
+	if (!FootstepSettings) { return; }
+
+	UFootstepComponent* FootstepComponent = FindFootstepComponent(MeshComp, FootstepCategory);
+	if (!FootstepComponent) { return; }
+
+	const float NotifyWeight = GetNotifyWeight(MeshComp, EventReference);
+	if (NotifyWeight < FootstepSettings->GetMinNotifyWeight()) { return; }
+
+	FFootstepRequest Request = MakeFootstepRequest(MeshComp, Animation, FootstepCategory, FootstepTraceDirection, TraceFromFootSocket() ? FootSocket : NAME_None);
+	Request.Weight = NotifyWeight;
+	SetThrottling(Request, MeshComp, Animation, EventReference);
+
+	FootstepComponent->RequestFootstep(Request);
+}
+
+UFootstepComponent* UAnimNotify_SurfaceFootstep::FindFootstepComponent(USkeletalMeshComponent* MeshComp, const FGameplayTag& InFootstepCategory)
+{
+	const USurfaceFootstepSystemSettings* Settings = USurfaceFootstepSystemSettings::Get();
+
 	// Check the most important conditions
-	if ( !(FootstepSettings && MeshComp && MeshComp->GetWorld() && !MeshComp->IsNetMode(NM_DedicatedServer) && MeshComp->GetOwner()) ) { return; }
+	if ( !(Settings && MeshComp && MeshComp->GetWorld() && MeshComp->GetOwner()) ) { return nullptr; }
 
-	if (FootstepSettings->GetCategoriesNum() == 0)
+	// A Dedicated Server runs the event-only mode, if enabled
+	if (MeshComp->IsNetMode(NM_DedicatedServer) && !Settings->GetReportNoiseEvents()) { return nullptr; }
+
+	if (Settings->GetCategoriesNum() == 0)
 	{
 		FMessageLog("PIE").Error(LOCTEXT("InvalidCategory", "There is no Footstep Category. Add any Footstep Category in the Surface Footstep System Settings in the Project Settings."));
-		return;
+		return nullptr;
 	}
 
-	if (!FootstepSettings->ContainsCategory(FootstepCategory))
+	if (!Settings->ContainsCategory(InFootstepCategory))
 	{
-		FMessageLog("PIE").Error( FText::Format(LOCTEXT("InvalidCategory", "\"{0}\" category is invalid. Add this Footstep Category in the Surface Footstep System Settings in the Project Settings or use a proper Footstep Category in the Surface Footstep Anim Notify."), FText::FromName(FootstepCategory.GetTagName())) );
-		return;
-	}
-
-	UFootstepPoolingManager* PoolingManager = MeshComp->GetWorld()->GetSubsystem<UFootstepPoolingManager>();
-
-	if (!PoolingManager)
-	{
-		return;
+		FMessageLog("PIE").Error( FText::Format(LOCTEXT("InvalidCategory", "\"{0}\" category is invalid. Add this Footstep Category in the Surface Footstep System Settings in the Project Settings or use a proper Footstep Category in the Surface Footstep Anim Notify."), FText::FromName(InFootstepCategory.GetTagName())) );
+		return nullptr;
 	}
 
 	AActor* MeshOwner = MeshComp->GetOwner();
@@ -64,23 +83,23 @@ void UAnimNotify_SurfaceFootstep::Notify(USkeletalMeshComponent* MeshComp, UAnim
 		FootstepComponent = IFootstepInterface::Execute_GetFootstepComponent(MeshOwner);
 	}
 
-	if (!(FootstepComponent && FootstepComponent->IsActive()))
-	{
-		return;
-	}
+	return FootstepComponent && FootstepComponent->IsActive() ? FootstepComponent : nullptr;
+}
 
+FFootstepRequest UAnimNotify_SurfaceFootstep::MakeFootstepRequest(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FGameplayTag& InFootstepCategory, EFootstepTraceDirection InTraceDirection, FName InFootSocket)
+{
 	// Prepare tracing
-	const bool bUseFootSocketLocation = TraceFromFootSocket() && MeshComp->DoesSocketExist(FootSocket);
-	const FVector StartTrace = bUseFootSocketLocation ? MeshComp->GetSocketLocation(FootSocket) : MeshComp->GetComponentLocation();
+	const bool bUseFootSocketLocation = InFootSocket != NAME_None && MeshComp->DoesSocketExist(InFootSocket);
+	const FVector StartTrace = bUseFootSocketLocation ? MeshComp->GetSocketLocation(InFootSocket) : MeshComp->GetComponentLocation();
 
-	const FVector DirectionVector = Invoke([this, bUseFootSocketLocation, MeshComp]()->FVector const {
+	const FVector DirectionVector = Invoke([bUseFootSocketLocation, MeshComp, InFootSocket, InTraceDirection]()->FVector const {
 		const FVector DefaultDirVector = FVector::DownVector;
 
 		if (bUseFootSocketLocation)
 		{
-			const FRotator SocketRotation = MeshComp->GetSocketRotation(FootSocket);
+			const FRotator SocketRotation = MeshComp->GetSocketRotation(InFootSocket);
 
-			switch (FootstepTraceDirection)
+			switch (InTraceDirection)
 			{
 			case EFootstepTraceDirection::Down:
 				return FRotationMatrix(SocketRotation).GetScaledAxis(EAxis::Z) * -1.0;
@@ -99,7 +118,7 @@ void UAnimNotify_SurfaceFootstep::Notify(USkeletalMeshComponent* MeshComp, UAnim
 			}
 		}
 		
-		switch (FootstepTraceDirection)
+		switch (InTraceDirection)
 		{
 			case EFootstepTraceDirection::Down:
 				return MeshComp->GetUpVector() * -1.0;
@@ -118,105 +137,80 @@ void UAnimNotify_SurfaceFootstep::Notify(USkeletalMeshComponent* MeshComp, UAnim
 		}
 	});
 
-	FHitResult TraceHitResult;
-	const bool bTracePerformed = FootstepComponent->CreateFootstepLineTrace(StartTrace, DirectionVector, TraceHitResult);
+	FFootstepRequest Request;
+	Request.Category = InFootstepCategory;
+	Request.TraceStart = StartTrace;
+	Request.TraceDirection = DirectionVector;
+	Request.SocketName = InFootSocket;
+	Request.Animation = Animation;
+
+	return Request;
+}
+
+FString UAnimNotify_SurfaceFootstep::GetNotifyName_Implementation() const
+{
+	return TraceFromFootSocket() ? Super::GetNotifyName_Implementation() + TEXT("_") + FootSocket.ToString() : Super::GetNotifyName_Implementation();
+}
 
-	if (!(bTracePerformed && TraceHitResult.bBlockingHit)) { return; }
+bool UAnimNotify_SurfaceFootstep::TraceFromFootSocket() const
+{
+	return bTraceFromFootSocket && FootSocket != NAME_None;
+}
 
-	// Get the Physical Material from the TraceHitResult
-	const UPhysicalMaterial* PhysMat = Invoke([&TraceHitResult]()->UPhysicalMaterial* const
+float UAnimNotify_SurfaceFootstep::GetNotifyWeight(USkeletalMeshComponent* MeshComp, const FAnimNotifyEventReference& EventReference)
+{
+	if (const UE::Anim::FAnimNotifyMontageInstanceContext* MontageContext = EventReference.GetContextData<UE::Anim::FAnimNotifyMontageInstanceContext>())
 	{
-		if (TraceHitResult.PhysMaterial.IsValid())
+		if (UAnimInstance* AnimInstance = MeshComp->GetAnimInstance())
 		{
-			return TraceHitResult.PhysMaterial.Get();
-		}
-		if (TraceHitResult.Component.IsValid())
-		{
-			if (const FBodyInstance* BodyInstance = TraceHitResult.GetComponent()->GetBodyInstance())
+			if (const FAnimMontageInstance* MontageInstance = AnimInstance->GetMontageInstanceForID(MontageContext->MontageInstanceID))
 			{
-				return BodyInstance->GetSimplePhysicalMaterial();
+				return MontageInstance->GetWeight();
 			}
 		}
+	}
 
-		return nullptr;
-	});
-
-	if (!PhysMat) { return; }
+	return 1.f;
+}
 
-	// Get data from a Data Asset
-	if (const UFootstepDataAsset* FootstepData = FootstepComponent->GetFootstepData(PhysMat->SurfaceType))
+void UAnimNotify_SurfaceFootstep::SetThrottling(FFootstepRequest& Request, USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	int32 TickRate = 1;
+	if (MeshComp->IsUsingExternalTickRateControl())
 	{
-		if (GEngine && FootstepComponent->GetShowDebug())
-		{
-			const FString PhysMatName = PhysMat->GetName();
-			const FString DataAssetName = FootstepData->GetName();
-			const FString AnimationName = Animation->GetName();
-			const FString CategoryName = FootstepCategory.ToString();
-			const FString SocketName = TraceFromFootSocket() ? FootSocket.ToString() : TEXT("ROOT");
-			const FString OwnerName = GetActorName(MeshOwner);
-
-			const FString DebugMessage = TEXT("PhysMat: ") + PhysMatName + TEXT(", DataAsset: ") + DataAssetName + TEXT(", Anim: ") + AnimationName + TEXT(", Category: ") + CategoryName + TEXT(", Socket: ") + SocketName + TEXT(", Owner: ") + OwnerName + TEXT(", HitActor: ") + GetActorName(TraceHitResult.GetActor()) + TEXT(", HitComp: ") + TraceHitResult.GetComponent()->GetName();
-
-			GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Green, DebugMessage);
-			UE_LOG(LogFootstep, Log, TEXT("%s"), *DebugMessage);
-		}
-
-		USoundBase* FootstepSound = FootstepData->GetSound(FootstepCategory);
-		UFXSystemAsset* FootstepParticle = FootstepData->GetParticle(FootstepCategory);
-		
-		// Finally, activate a footstep actor
-		if (FootstepSound || FootstepParticle)
-		{
-			PoolingManager->SafeSpawnPooledActor();
-
-			constexpr bool bRemoveInvalidActors = false;
-			if (AFootstepActor* FootstepActor = PoolingManager->GetPooledActor(bRemoveInvalidActors))
-			{
-				FootstepActor->SetPoolingActive(false);
-
-				const FQuat ActorQuat = FootstepParticle ? FRotationMatrix::MakeFromZ(TraceHitResult.ImpactNormal).ToQuat() : FQuat(EForceInit::ForceInitToZero);
-				const FTransform WorldTransform = FTransform(ActorQuat, TraceHitResult.ImpactPoint, FVector::OneVector);
-				const FVector RelScaleVFX = FootstepParticle ? FootstepData->GetRelScaleParticle() : FVector::ZeroVector;
+		TickRate = MeshComp->GetExternalTickRate();
+	}
+	else if (MeshComp->ShouldUseUpdateRateOptimizations() && MeshComp->AnimUpdateRateParams)
+	{
+		TickRate = MeshComp->AnimUpdateRateParams->UpdateRate;
+	}
 
-				FootstepActor->SetActorTransform(WorldTransform);
+	if (TickRate <= 1) { return; }
 
-				const float Volume = FootstepSound ? FootstepData->GetVolume() : 0.f;
-				const float Pitch = FootstepSound ? FootstepData->GetPitch() : 0.f;
-				const float SoundAssetVolume = FootstepSound ? FootstepSound->GetVolumeMultiplier() : 0.f;
-				const float SoundAssetPitch = FootstepSound ? FootstepSound->GetPitchMultiplier() : 0.f;
+	Request.bThrottled = true;
 
-				FootstepActor->InitSound(FootstepSound, Volume, Pitch, FootstepComponent->GetPlaySound2D(), FootstepData->GetAttenuationOverride(), FootstepData->GetConcurrencyOverride());
-				FootstepActor->InitParticle(FootstepParticle, RelScaleVFX);
+	const FAnimNotifyEvent* NotifyEvent = EventReference.GetNotify();
+	if (!(NotifyEvent && Animation)) { return; }
 
-				FootstepActor->SetLifeSpan(FootstepData->GetFootstepLifeSpan());
-				FootstepActor->SetPoolingActive(true);
+	// A notify state generates its footstep at the end
+	const float TriggerTime = NotifyEvent->NotifyStateClass ? NotifyEvent->GetEndTriggerTime() : NotifyEvent->GetTriggerTime();
+	float Lateness = EventReference.GetCurrentAnimationTime() - TriggerTime;
 
-				FootstepComponent->OnFootstepGenerated.Broadcast(PhysMat->SurfaceType, FootstepCategory, WorldTransform, Volume, Pitch, SoundAssetVolume, SoundAssetPitch, RelScaleVFX);
-			}
-		}
+	// The animation may have looped since the notify
+	if (Lateness < 0.f)
+	{
+		Lateness += Animation->GetPlayLength();
 	}
-}
-
-FString UAnimNotify_SurfaceFootstep::GetNotifyName_Implementation() const
-{
-	return TraceFromFootSocket() ? Super::GetNotifyName_Implementation() + TEXT("_") + FootSocket.ToString() : Super::GetNotifyName_Implementation();
-}
-
-bool UAnimNotify_SurfaceFootstep::TraceFromFootSocket() const
-{
-	return bTraceFromFootSocket && FootSocket != NAME_None;
-}
 
-FString UAnimNotify_SurfaceFootstep::GetActorName(const AActor* Actor) const
-{
-	if (!Actor) { return FString(); }
-
-#if WITH_EDITOR
-	return Actor->GetActorLabel();
-#else
-	return Actor->GetName();
-#endif
+	const float RateScale = FMath::Abs(Animation->RateScale);
+	if (RateScale > UE_KINDA_SMALL_NUMBER)
+	{
+		Lateness /= RateScale;
+	}
 
+	// A notify can't be later than the ticks skipped before it
+	const float MaxLateness = TickRate * MeshComp->GetWorld()->GetDeltaSeconds();
+	Request.Lateness = FMath::Clamp(Lateness, 0.f, MaxLateness);
 }
 
 #undef LOCTEXT_NAMESPACE
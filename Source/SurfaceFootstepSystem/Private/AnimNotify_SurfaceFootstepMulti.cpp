@@ -0,0 +1,61 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "AnimNotify_SurfaceFootstepMulti.h"
+#include "FootstepComponent.h"
+#include "SurfaceFootstepSystemSettings.h"
+#include "FootstepTypes.h"
+#include "Components/SkeletalMeshComponent.h"
+
+UAnimNotify_SurfaceFootstepMulti::UAnimNotify_SurfaceFootstepMulti(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, bMergeSameSurface(true)
+{
+#if WITH_EDITORONLY_DATA
+	NotifyColor = FColor(0, 188, 0, 255);
+#endif
+
+	FootstepSettings = USurfaceFootstepSystemSettings::Get();
+
+	if (FootstepSettings)
+	{
+		FootstepCategory = FootstepSettings->GetCategoriesNum() > 0 ? FootstepSettings->GetCategoryName(0) : FGameplayTag::EmptyTag;
+	}
+}
+
+void UAnimNotify_SurfaceFootstepMulti::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::Notify(MeshComp, Animation, EventReference);
+
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepNotify);
+	LLM_SCOPE_BYTAG(Footstep);
+	FOOTSTEP_ALLOCATION_GUARD_SCOPE(TEXT("UAnimNotify_SurfaceFootstepMulti::Notify"));
+
+	if (!(FootstepSettings && FootSockets.Num() > 0)) { return; }
+
+	// The component lookup and the category checks are shared by all feet
+	UFootstepComponent* FootstepComponent = UAnimNotify_SurfaceFootstep::FindFootstepComponent(MeshComp, FootstepCategory);
+	if (!FootstepComponent) { return; }
+
+	const float NotifyWeight = UAnimNotify_SurfaceFootstep::GetNotifyWeight(MeshComp, EventReference);
+	if (NotifyWeight < FootstepSettings->GetMinNotifyWeight()) { return; }
+
+	// All feet land on the same frame, so they share the throttling state
+	FFootstepRequest Throttling;
+	UAnimNotify_SurfaceFootstep::SetThrottling(Throttling, MeshComp, Animation, EventReference);
+
+	TArray<FFootstepRequest, TInlineAllocator<4>> Requests;
+	for (const FName& FootSocket : FootSockets)
+	{
+		FFootstepRequest& Request = Requests.Add_GetRef(UAnimNotify_SurfaceFootstep::MakeFootstepRequest(MeshComp, Animation, FootstepCategory, FootstepTraceDirection, FootSocket));
+		Request.Weight = NotifyWeight;
+		Request.bThrottled = Throttling.bThrottled;
+		Request.Lateness = Throttling.Lateness;
+	}
+
+	FootstepComponent->RequestFootsteps(Requests, bMergeSameSurface);
+}
+
+FString UAnimNotify_SurfaceFootstepMulti::GetNotifyName_Implementation() const
+{
+	return FString::Printf(TEXT("%s_x%d"), *Super::GetNotifyName_Implementation(), FootSockets.Num());
+}
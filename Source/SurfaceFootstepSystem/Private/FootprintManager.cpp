@@ -0,0 +1,172 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootprintManager.h"
+#include "SurfaceFootstepSystemSettings.h"
+#include "FootstepTypes.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "Engine.h"
+#include "Engine/World.h"
+
+UFootprintManager::UFootprintManager()
+	: Super()
+{
+}
+
+void UFootprintManager::ClearFootprints(const UObject* WorldContextObject)
+{
+	if (!GEngine) { return; }
+
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull))
+	{
+		if (UFootprintManager* FootprintManager = World->GetSubsystem<UFootprintManager>())
+		{
+			FootprintManager->DestroyFootprints();
+		}
+	}
+}
+
+bool UFootprintManager::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (Super::ShouldCreateSubsystem(Outer))
+	{
+		if (const UWorld* World = Cast<UWorld>(Outer))
+		{
+			return !World->IsNetMode(NM_DedicatedServer);
+		}
+	}
+
+	return false;
+}
+
+void UFootprintManager::Deinitialize()
+{
+	DestroyFootprints();
+
+	if (IsValid(FootprintActor))
+	{
+		FootprintActor->Destroy();
+	}
+	FootprintActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UFootprintManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	LLM_SCOPE_BYTAG(Footstep);
+
+	// Instances are updated without touching the render state, so it's sent once per frame for every batch
+	for (FFootprintBatch& Batch : FootprintBatches)
+	{
+		if (Batch.bRenderStateDirty && IsValid(Batch.Component))
+		{
+			Batch.Component->MarkRenderStateDirty();
+		}
+		Batch.bRenderStateDirty = false;
+	}
+}
+
+TStatId UFootprintManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFootprintManager, STATGROUP_Tickables);
+}
+
+void UFootprintManager::AddFootprint(UStaticMesh* Mesh, UMaterialInterface* Material, const FTransform& Transform, float LifeSpan)
+{
+	const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+	if (!(Mesh && FootstepSettings)) { return; }
+
+	LLM_SCOPE_BYTAG(Footstep);
+
+	FFootprintBatch* Batch = FindOrAddBatch(Mesh, Material);
+	if (!(Batch && IsValid(Batch->Component))) { return; }
+
+	UInstancedStaticMeshComponent* Component = Batch->Component;
+	const float SpawnTime = GetWorld()->GetTimeSeconds();
+
+	constexpr bool bWorldSpace = true;
+	constexpr bool bMarkRenderStateDirty = false;
+	constexpr bool bTeleport = true;
+
+	if (Component->GetInstanceCount() < FootstepSettings->GetMaxFootprints())
+	{
+		Batch->NextInstance = Component->AddInstance(Transform, bWorldSpace);
+	}
+	else
+	{
+		Component->UpdateInstanceTransform(Batch->NextInstance, Transform, bWorldSpace, bMarkRenderStateDirty, bTeleport);
+	}
+
+	Component->SetCustomDataValue(Batch->NextInstance, 0, SpawnTime, bMarkRenderStateDirty);
+	Component->SetCustomDataValue(Batch->NextInstance, 1, LifeSpan, bMarkRenderStateDirty);
+
+	Batch->NextInstance = (Batch->NextInstance + 1) % FootstepSettings->GetMaxFootprints();
+	Batch->bRenderStateDirty = true;
+}
+
+void UFootprintManager::DestroyFootprints()
+{
+	for (const FFootprintBatch& Batch : FootprintBatches)
+	{
+		if (IsValid(Batch.Component))
+		{
+			Batch.Component->DestroyComponent();
+		}
+	}
+
+	FootprintBatches.Reset();
+}
+
+FFootprintBatch* UFootprintManager::FindOrAddBatch(UStaticMesh* Mesh, UMaterialInterface* Material)
+{
+	for (FFootprintBatch& Batch : FootprintBatches)
+	{
+		if (Batch.Mesh == Mesh && Batch.Material == Material)
+		{
+			return &Batch;
+		}
+	}
+
+	UWorld* World = GetWorld();
+
+	if (!IsValid(FootprintActor))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		FootprintActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!FootprintActor) { return nullptr; }
+
+		USceneComponent* RootComponent = NewObject<USceneComponent>(FootprintActor, TEXT("RootComponent"));
+		FootprintActor->SetRootComponent(RootComponent);
+		RootComponent->RegisterComponent();
+	}
+
+	UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(FootprintActor);
+	Component->SetStaticMesh(Mesh);
+	if (Material)
+	{
+		for (int32 i = 0; i < Component->GetNumMaterials(); ++i)
+		{
+			Component->SetMaterial(i, Material);
+		}
+	}
+	Component->NumCustomDataFloats = 2;
+	Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Component->SetCanEverAffectNavigation(false);
+	Component->SetCastShadow(false);
+	Component->SetupAttachment(FootprintActor->GetRootComponent());
+	Component->RegisterComponent();
+
+	FFootprintBatch& Batch = FootprintBatches.AddDefaulted_GetRef();
+	Batch.Mesh = Mesh;
+	Batch.Material = Material;
+	Batch.Component = Component;
+
+	return &Batch;
+}
@@ -1,16 +1,22 @@
 // Copyright Urszula Kustra. All Rights Reserved.
 
 #include "FootstepActor.h"
+#include "FootstepAllocationGuard.h"
 #include "Components/AudioComponent.h"
-#include "Particles/ParticleSystemComponent.h"
 #include "NiagaraComponent.h"
 #include "NiagaraSystem.h"
+#if SFS_WITH_CASCADE
+#include "Particles/ParticleSystemComponent.h"
 #include "Particles/ParticleSystem.h"
-#include "TimerManager.h"
+#endif
 
 AFootstepActor::AFootstepActor(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
-	, UseComponentTag(TEXT("UseComponent"))
+	, PoolingSerial(0)
+	, bPoolingActive(false)
+	, bUseAudio(false)
+	, bUseCascade(false)
+	, bUseNiagara(false)
 {
 	PrimaryActorTick.bCanEverTick = false;
 	PrimaryActorTick.bStartWithTickEnabled = false;
@@ -22,60 +28,42 @@ AFootstepActor::AFootstepActor(const FObjectInitializer& ObjectInitializer)
 	AudioComponent->bAutoActivate = false;
 	AudioComponent->SetupAttachment(RootComponent.Get());
 
+#if SFS_WITH_CASCADE
 	ParticleComponent = ObjectInitializer.CreateDefaultSubobject<UParticleSystemComponent>(this, TEXT("ParticleComponent"));
 	ParticleComponent->bAutoActivate = false;
 	ParticleComponent->SetupAttachment(RootComponent.Get());
+#endif
 
 	NiagaraComponent = ObjectInitializer.CreateDefaultSubobject<UNiagaraComponent>(this, TEXT("NiagaraComponent"));
 	NiagaraComponent->bAutoActivate = false;
 	NiagaraComponent->SetupAttachment(RootComponent.Get());
 }
 
-void AFootstepActor::SetLifeSpan(float InLifespan)
-{
-	PoolingLifeSpan = InLifespan;
-
-	if (PoolingLifeSpan > 0.f)
-	{
-		GetWorldTimerManager().SetTimer(PoolingTimer, FTimerDelegate::CreateWeakLambda(this, [this]() {
-			SetPoolingActive(false);
-		}), PoolingLifeSpan, false);
-	}
-	else
-	{
-		SetPoolingActive(false);
-	}
-}
-
-void AFootstepActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
-{
-	Super::EndPlay(EndPlayReason);
-
-	GetWorldTimerManager().ClearTimer(PoolingTimer);
-}
-
 void AFootstepActor::SetPoolingActive(bool bInActive)
 {
-	check(AudioComponent && ParticleComponent && NiagaraComponent);
-
-	const bool bUseAudio = AudioComponent->ComponentHasTag(UseComponentTag);
-	const bool bUseCascade = ParticleComponent->ComponentHasTag(UseComponentTag);
-	const bool bUseNiagara = NiagaraComponent->ComponentHasTag(UseComponentTag);
+	check(AudioComponent && NiagaraComponent);
 
 	if (bInActive && (bUseAudio || bUseCascade || bUseNiagara))
 	{
 		bPoolingActive = true;
+		++PoolingSerial;
+
+		// The engine components allocate when they start playing, which the footstep path doesn't control
+		FOOTSTEP_ALLOCATION_GUARD_SUSPEND();
 
 		if (bUseAudio)
 		{
 			AudioComponent->Play();
 		}
 
+#if SFS_WITH_CASCADE
 		if (bUseCascade)
 		{
 			ParticleComponent->Activate(true);
 		}
-		else if (bUseNiagara)
+		else
+#endif
+		if (bUseNiagara)
 		{
 			NiagaraComponent->Activate(true);
 		}
@@ -84,12 +72,14 @@ void AFootstepActor::SetPoolingActive(bool bInActive)
 	{
 		bPoolingActive = false;
 		AudioComponent->Stop();
-		ParticleComponent->Deactivate();
 		NiagaraComponent->Deactivate();
+#if SFS_WITH_CASCADE
+		ParticleComponent->Deactivate();
+#endif
 
-		AudioComponent->ComponentTags.Reset();
-		ParticleComponent->ComponentTags.Reset();
-		NiagaraComponent->ComponentTags.Reset();
+		bUseAudio = false;
+		bUseCascade = false;
+		bUseNiagara = false;
 	}
 }
 
@@ -98,7 +88,19 @@ bool AFootstepActor::IsPoolingActive() const
 	return bPoolingActive;
 }
 
-void AFootstepActor::InitSound(USoundBase* Sound, float Volume, float Pitch, bool bIs2D, USoundAttenuation* AttenuationOverride, USoundConcurrency* ConcurrencyOverride) const
+uint32 AFootstepActor::GetPoolingSerial() const
+{
+	return PoolingSerial;
+}
+
+bool AFootstepActor::IsPlayingSound(USoundConcurrency* Concurrency) const
+{
+	check(AudioComponent);
+
+	return bPoolingActive && AudioComponent->IsPlaying() && AudioComponent->ConcurrencySet.Contains(Concurrency);
+}
+
+void AFootstepActor::InitSound(USoundBase* Sound, float Volume, float Pitch, bool bIs2D, USoundAttenuation* AttenuationOverride, USoundConcurrency* ConcurrencyOverride)
 {
 	if (!Sound) { return; }
 
@@ -126,31 +128,37 @@ void AFootstepActor::InitSound(USoundBase* Sound, float Volume, float Pitch, boo
 		AudioComponent->AttenuationSettings = AttenuationOverride;
 	}
 
-	AudioComponent->ConcurrencySet.Empty();
+	// Keeps the allocation of the set for the next footstep
+	AudioComponent->ConcurrencySet.Reset();
 	if (ConcurrencyOverride)
 	{
 		AudioComponent->ConcurrencySet.Add(ConcurrencyOverride);
 	}
 
-	AudioComponent->ComponentTags.AddUnique(UseComponentTag);
+	bUseAudio = true;
 }
 
-void AFootstepActor::InitParticle(UFXSystemAsset* Particle, const FVector& RelativeScale) const
+void AFootstepActor::InitParticle(UFXSystemAsset* Particle, const FVector& RelativeScale)
 {
 	if (!Particle) { return; }
 
-	check(ParticleComponent && NiagaraComponent);
+	check(NiagaraComponent);
 
+#if SFS_WITH_CASCADE
 	if (UParticleSystem* ParticleSystem = Cast<UParticleSystem>(Particle))
 	{
+		check(ParticleComponent);
+
 		ParticleComponent->SetTemplate(ParticleSystem);
 		ParticleComponent->SetRelativeScale3D(RelativeScale);
-		ParticleComponent->ComponentTags.AddUnique(UseComponentTag);
+		bUseCascade = true;
 	}
-	else if (UNiagaraSystem* NiagaraSystem = Cast<UNiagaraSystem>(Particle))
+	else
+#endif
+	if (UNiagaraSystem* NiagaraSystem = Cast<UNiagaraSystem>(Particle))
 	{
 		NiagaraComponent->SetAsset(NiagaraSystem);
 		NiagaraComponent->SetRelativeScale3D(RelativeScale);
-		NiagaraComponent->ComponentTags.AddUnique(UseComponentTag);
+		bUseNiagara = true;
 	}
 }
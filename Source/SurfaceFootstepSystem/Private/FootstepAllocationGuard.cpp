@@ -0,0 +1,195 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootstepAllocationGuard.h"
+
+#if FOOTSTEP_ALLOCATION_GUARD
+
+#include "FootstepTypes.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+namespace FootstepAllocationGuard
+{
+	static thread_local int32 GuardDepth = 0;
+	static thread_local int32 SuspendDepth = 0;
+	static thread_local uint32 NumAllocations = 0;
+	static thread_local uint64 NumThreadAllocations = 0;
+
+	static bool bEnabled = false;
+
+	static FORCEINLINE void CountAllocation()
+	{
+		++NumThreadAllocations;
+
+		if (GuardDepth > 0 && SuspendDepth == 0)
+		{
+			++NumAllocations;
+		}
+	}
+}
+
+/**
+ * Forwards everything to the wrapped allocator and counts allocations of each thread, and of threads which are inside a guard scope.
+ */
+class FFootstepAllocationGuardMalloc final : public FMalloc
+{
+public:
+	explicit FFootstepAllocationGuardMalloc(FMalloc* InMalloc)
+		: InnerMalloc(InMalloc)
+	{
+	}
+
+	//~ Begin FMalloc Interface
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		FootstepAllocationGuard::CountAllocation();
+		return InnerMalloc->Malloc(Count, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+	{
+		FootstepAllocationGuard::CountAllocation();
+		return InnerMalloc->TryMalloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		FootstepAllocationGuard::CountAllocation();
+		return InnerMalloc->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		FootstepAllocationGuard::CountAllocation();
+		return InnerMalloc->TryRealloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override
+	{
+		InnerMalloc->Free(Original);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return InnerMalloc->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return InnerMalloc->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual void Trim(bool bTrimThreadCaches) override
+	{
+		InnerMalloc->Trim(bTrimThreadCaches);
+	}
+
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		InnerMalloc->SetupTLSCachesOnCurrentThread();
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+
+	virtual void InitializeStatsMetadata() override
+	{
+		InnerMalloc->InitializeStatsMetadata();
+	}
+
+	virtual void UpdateStats() override
+	{
+		InnerMalloc->UpdateStats();
+	}
+
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+	{
+		InnerMalloc->GetAllocatorStats(OutStats);
+	}
+
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+	{
+		InnerMalloc->DumpAllocatorStats(Ar);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return InnerMalloc->IsInternallyThreadSafe();
+	}
+
+	virtual bool ValidateHeap() override
+	{
+		return InnerMalloc->ValidateHeap();
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return InnerMalloc->GetDescriptiveName();
+	}
+	//~ End FMalloc Interface
+
+private:
+	FMalloc* InnerMalloc;
+};
+
+void FootstepAllocationGuard::Initialize()
+{
+	if (bEnabled || !FParse::Param(FCommandLine::Get(), TEXT("FootstepAllocationGuard"))) { return; }
+
+	// This is racy: other threads read GMalloc without synchronization and may be inside the inner allocator while it's swapped.
+	// The swap is atomic and the inner allocator is never destroyed, so such calls still complete there, they're just not counted.
+	// Memory allocated before the wrapper is installed is freed through it, which is fine, because everything is forwarded. The wrapper is never removed
+	FMalloc* InnerMalloc = GMalloc;
+	FPlatformAtomics::InterlockedExchangePtr(reinterpret_cast<void**>(&GMalloc), new FFootstepAllocationGuardMalloc(InnerMalloc));
+	bEnabled = true;
+
+	UE_LOG(LogFootstep, Warning, TEXT("Footstep allocation guard is enabled. The allocator has been wrapped while the engine is running, use it for local debugging only."));
+}
+
+bool FootstepAllocationGuard::IsEnabled()
+{
+	return bEnabled;
+}
+
+uint64 FootstepAllocationGuard::GetNumThreadAllocations()
+{
+	return NumThreadAllocations;
+}
+
+FFootstepAllocationGuardScope::FFootstepAllocationGuardScope(const TCHAR* InName)
+	: Name(InName)
+	, StartAllocations(FootstepAllocationGuard::NumAllocations)
+{
+	++FootstepAllocationGuard::GuardDepth;
+}
+
+FFootstepAllocationGuardScope::~FFootstepAllocationGuardScope()
+{
+	using namespace FootstepAllocationGuard;
+
+	if (--GuardDepth > 0 || !bEnabled) { return; }
+
+	const uint32 NumScopeAllocations = NumAllocations - StartAllocations;
+	if (NumScopeAllocations > 0)
+	{
+		// Reporting allocates too
+		FFootstepAllocationGuardSuspendScope SuspendScope;
+		ensureMsgf(false, TEXT("%u heap allocation(s) in the steady-state footstep path (%s)."), NumScopeAllocations, Name);
+		UE_LOG(LogFootstep, Warning, TEXT("%u heap allocation(s) in the steady-state footstep path (%s)."), NumScopeAllocations, Name);
+	}
+}
+
+FFootstepAllocationGuardSuspendScope::FFootstepAllocationGuardSuspendScope()
+{
+	++FootstepAllocationGuard::SuspendDepth;
+}
+
+FFootstepAllocationGuardSuspendScope::~FFootstepAllocationGuardSuspendScope()
+{
+	--FootstepAllocationGuard::SuspendDepth;
+}
+
+#endif
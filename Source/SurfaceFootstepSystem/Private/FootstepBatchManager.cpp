@@ -0,0 +1,178 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootstepBatchManager.h"
+#include "FootstepComponent.h"
+#include "FootstepPoolingManager.h"
+#include "FootstepScalability.h"
+#include "Engine/World.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Async/ParallelFor.h"
+
+#if ENABLE_DRAW_DEBUG
+#include "KismetTraceUtils.h"
+#endif
+
+/** Smaller batches aren't worth scheduling tasks for. */
+static constexpr int32 FootstepBatchMinSize = 16;
+
+UFootstepBatchManager::UFootstepBatchManager()
+	: Super()
+{
+}
+
+bool UFootstepBatchManager::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (Super::ShouldCreateSubsystem(Outer))
+	{
+		if (const UWorld* World = Cast<UWorld>(Outer))
+		{
+			return !World->IsNetMode(NM_DedicatedServer);
+		}
+	}
+
+	return false;
+}
+
+void UFootstepBatchManager::Deinitialize()
+{
+	PendingFootsteps.Empty();
+	ProcessingFootsteps.Empty();
+
+	Super::Deinitialize();
+}
+
+void UFootstepBatchManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingFootsteps.IsEmpty()) { return; }
+
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepBatch);
+	LLM_SCOPE_BYTAG(Footstep);
+
+	// Footsteps requested while this batch is applied go to the next one
+	Swap(PendingFootsteps, ProcessingFootsteps);
+	ProcessFootsteps();
+	ProcessingFootsteps.Reset();
+}
+
+TStatId UFootstepBatchManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFootstepBatchManager, STATGROUP_Tickables);
+}
+
+void UFootstepBatchManager::AddFootstep(UFootstepComponent* Component, const FFootstepRequest& Request, bool bGenerateEvents, uint32 MergeGroup)
+{
+	if (!Component) { return; }
+
+	LLM_SCOPE_BYTAG(Footstep);
+
+	FFootstepBatchEntry& Entry = PendingFootsteps.AddDefaulted_GetRef();
+	Entry.Component = Component;
+	Entry.Request = Request;
+	Entry.TraceEnd = Request.TraceStart + (Request.TraceDirection.GetSafeNormal() * Component->GetTraceLength());
+	Entry.bGenerateEvents = bGenerateEvents;
+	Entry.MergeGroup = MergeGroup;
+
+	Component->MakeTraceParams(Entry.QueryParams, Entry.ObjectParams);
+}
+
+void UFootstepBatchManager::ProcessFootsteps()
+{
+	UWorld* World = GetWorld();
+	UFootstepPoolingManager* PoolingManager = World->GetSubsystem<UFootstepPoolingManager>();
+
+	if (!PoolingManager) { return; }
+
+	// CVars can only be read on the game thread
+	const float CullDistance = FootstepScalability::GetCullDistance();
+
+	// Culling, traces and surface lookup only read the world
+	ParallelFor(TEXT("Footstep.Batch.Resolve"), ProcessingFootsteps.Num(), FootstepBatchMinSize, [this, World, PoolingManager, CullDistance](int32 Index)
+	{
+		FFootstepBatchEntry& Entry = ProcessingFootsteps[Index];
+		const UFootstepComponent* Component = Entry.Component.Get();
+
+		if (!Component) { return; }
+
+		Entry.bInCullDistance = PoolingManager->IsInCullDistance(Entry.Request.TraceStart, CullDistance);
+
+		if (!(Entry.bInCullDistance || Entry.bGenerateEvents)) { return; }
+
+		{
+			FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepTrace);
+			Entry.bHit = World->LineTraceSingleByObjectType(Entry.HitResult, Entry.Request.TraceStart, Entry.TraceEnd, Entry.ObjectParams, Entry.QueryParams) && Entry.HitResult.bBlockingHit;
+		}
+
+		Entry.PhysMat = Entry.bHit ? UFootstepComponent::GetHitPhysicalMaterial(Entry.HitResult) : nullptr;
+		Entry.DataAssetPtr = Entry.PhysMat ? Component->FindFootstepData(Entry.PhysMat->SurfaceType) : nullptr;
+	});
+
+	// Loading is only allowed on the game thread
+	for (FFootstepBatchEntry& Entry : ProcessingFootsteps)
+	{
+		Entry.DataAsset = Entry.DataAssetPtr ? FootstepAsset::LoadSynchronous(*Entry.DataAssetPtr) : nullptr;
+	}
+
+	// Every footstep has its own random stream, so the results don't depend on which thread has picked it
+	const uint32 BatchSeed = static_cast<uint32>(GFrameCounter);
+
+	ParallelFor(TEXT("Footstep.Batch.Variation"), ProcessingFootsteps.Num(), FootstepBatchMinSize, [this, BatchSeed](int32 Index)
+	{
+		FFootstepBatchEntry& Entry = ProcessingFootsteps[Index];
+
+		if (!Entry.DataAsset) { return; }
+
+		FRandomStream RandomStream(static_cast<int32>(HashCombine(BatchSeed, static_cast<uint32>(Index))));
+		Entry.Variation = Entry.DataAsset->SelectVariation(Entry.Request.Category, RandomStream);
+	});
+
+	// Surface Types which have already played a sound in the current merge group
+	TArray<EPhysicalSurface, TInlineAllocator<4>> SoundSurfaces;
+	const UFootstepComponent* MergeComponent = nullptr;
+	uint32 MergeGroup = 0;
+
+	// Only the application touches actors and components
+	for (const FFootstepBatchEntry& Entry : ProcessingFootsteps)
+	{
+		UFootstepComponent* Component = Entry.Component.Get();
+
+		if (!(Component && Component->IsActive())) { continue; }
+
+		// Groups are numbered per component and their feet are queued one after another
+		if (Entry.MergeGroup != MergeGroup || Component != MergeComponent)
+		{
+			SoundSurfaces.Reset();
+			MergeComponent = Component;
+			MergeGroup = Entry.MergeGroup;
+		}
+
+		// The per frame budget is consumed in the request order, like without batching
+		const bool bGenerateFX = PoolingManager->ApplyFootstepBudget(Entry.bInCullDistance);
+
+		if (!(bGenerateFX || Entry.bGenerateEvents)) { continue; }
+
+#if ENABLE_DRAW_DEBUG
+		if (Component->GetShowDebug())
+		{
+			DrawDebugLineTraceSingle(World, Entry.Request.TraceStart, Entry.TraceEnd, EDrawDebugTrace::Type::ForDuration, Entry.bHit, Entry.HitResult, FLinearColor::Red, FLinearColor::Green, 2.f);
+		}
+#endif
+
+		const FFootstepVariation* Variation = Entry.DataAsset ? &Entry.Variation : nullptr;
+
+		if (Entry.MergeGroup != 0)
+		{
+			Component->GenerateMergedFootstep(Entry.Request, Entry.HitResult, Entry.PhysMat, bGenerateFX, SoundSurfaces, Variation);
+			continue;
+		}
+
+		if (!Entry.PhysMat)
+		{
+			FOOTSTEP_TRACE_FOOTSTEP(Component->GetOwner(), SurfaceType_Default, Entry.Request.Category, false, INDEX_NONE, false);
+			continue;
+		}
+
+		Component->GenerateFootstep(Entry.Request, Entry.HitResult, Entry.PhysMat, bGenerateFX, Variation);
+	}
+}
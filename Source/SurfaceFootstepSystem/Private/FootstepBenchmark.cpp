@@ -0,0 +1,1110 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "FootstepComponent.h"
+#include "FootstepBenchmarkActor.h"
+#include "AnimNotify_SurfaceFootstep.h"
+#include "FootstepPoolingManager.h"
+#include "FootstepActor.h"
+#include "FootstepDataAsset.h"
+#include "FootstepTypes.h"
+#include "FootstepRecording.h"
+#include "FootstepScalability.h"
+#include "SurfaceFootstepSystemSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimNotifyQueue.h"
+#include "GameplayTagsManager.h"
+#include "NiagaraSystem.h"
+#include "Sound/SoundBase.h"
+#include "UObject/UObjectIterator.h"
+#include "UObject/Package.h"
+#include "Tickable.h"
+#include "Containers/Ticker.h"
+#include "UObject/GCObject.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/AutomationTest.h"
+
+namespace FootstepBenchmark
+{
+	static double GetPercentile(TArray<double> Samples, double Percentile)
+	{
+		if (Samples.IsEmpty()) { return 0.0; }
+
+		Samples.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Samples.Num()) - 1, 0, Samples.Num() - 1);
+
+		return Samples[Index];
+	}
+
+	/** Allocations are counted per thread by the footstep allocation guard, so the render, audio and worker threads don't add noise. */
+	static bool CanCountAllocations()
+	{
+#if FOOTSTEP_ALLOCATION_GUARD
+		return FootstepAllocationGuard::IsEnabled();
+#else
+		return false;
+#endif
+	}
+
+	/** Allocations made by the current thread, or 0 if they can't be counted. */
+	static uint64 GetNumAllocations()
+	{
+#if FOOTSTEP_ALLOCATION_GUARD
+		return FootstepAllocationGuard::GetNumThreadAllocations();
+#else
+		return 0;
+#endif
+	}
+
+	/** Writes null if allocations can't be counted, so such results aren't mistaken for zero allocations. */
+	static void SetAllocationField(FJsonObject& Object, const FString& FieldName, double Value)
+	{
+		if (CanCountAllocations())
+		{
+			Object.SetNumberField(FieldName, Value);
+		}
+		else
+		{
+			Object.SetField(FieldName, MakeShared<FJsonValueNull>());
+		}
+	}
+
+	static void WarnIfAllocationsNotCounted()
+	{
+		if (!CanCountAllocations())
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep benchmark: allocations are counted only with -FootstepAllocationGuard in a Debug or Development build, they will be reported as null."));
+		}
+	}
+
+	static TSharedRef<FJsonObject> MakeFrameCostObject(const TArray<double>& Samples)
+	{
+		double Sum = 0.0;
+		for (const double Sample : Samples)
+		{
+			Sum += Sample;
+		}
+
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetNumberField(TEXT("mean"), Samples.Num() > 0 ? Sum / Samples.Num() : 0.0);
+		Object->SetNumberField(TEXT("p50"), GetPercentile(Samples, 0.5));
+		Object->SetNumberField(TEXT("p95"), GetPercentile(Samples, 0.95));
+		Object->SetNumberField(TEXT("p99"), GetPercentile(Samples, 0.99));
+
+		return Object;
+	}
+
+	/** The values of all footstep CVars, so results of different quality levels can be told apart. */
+	static TSharedRef<FJsonObject> MakeCVarsObject()
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+
+		IConsoleManager::Get().ForEachConsoleObjectThatStartsWith(FConsoleObjectVisitor::CreateLambda([&Object](const TCHAR* Name, IConsoleObject* ConsoleObject)
+		{
+			if (IConsoleVariable* CVar = ConsoleObject->AsVariable())
+			{
+				Object->SetStringField(Name, CVar->GetString());
+			}
+		}), TEXT("Footstep."));
+
+		return Object;
+	}
+
+	static void SaveResults(const TCHAR* BenchmarkName, const TSharedRef<FJsonObject>& Results)
+	{
+		FString Json;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+		FJsonSerializer::Serialize(Results, Writer);
+
+		const FString FilePath = FPaths::ProfilingDir() / TEXT("Footstep") / FString::Printf(TEXT("%s_%s.json"), BenchmarkName, *FDateTime::Now().ToString());
+		if (FFileHelper::SaveStringToFile(Json, *FilePath))
+		{
+			UE_LOG(LogFootstep, Display, TEXT("Footstep benchmark results have been written to %s"), *FilePath);
+		}
+		else
+		{
+			UE_LOG(LogFootstep, Error, TEXT("Couldn't write the footstep benchmark results to %s"), *FilePath);
+		}
+	}
+}
+
+/**
+ * Drives a crowd of footstep-only actors on the current map and measures the footstep pipeline. Each actor fires the Surface Footstep notify at a fixed cadence,
+ * like a looping walk animation would, on a mesh without a skeletal mesh asset, so the results include the notify but don't depend on animation or skinning cost.
+ * Stages with different crowd sizes run one after another and the results are written as JSON to the Profiling directory.
+ * Asynchronous traces and batching are turned off while it runs, so the whole cost of a footstep is spent inside the timed notifies.
+ */
+class FFootstepCrowdBenchmark : public FTickableGameObject, public FGCObject
+{
+public:
+	FFootstepCrowdBenchmark(UWorld* InWorld, UFootstepComponent* InTemplateComponent, TArray<int32>&& InCrowdSizes, float InStageDuration, float InStepInterval, bool bInExitWhenDone)
+		: World(InWorld)
+		, TemplateComponent(InTemplateComponent)
+		, CrowdSizes(MoveTemp(InCrowdSizes))
+		, StageDuration(InStageDuration)
+		, StepInterval(InStepInterval)
+		, bExitWhenDone(bInExitWhenDone)
+		, CurrentStage(INDEX_NONE)
+		, StageStartTime(0.0)
+		, StageStartAllocations(0)
+		, StageStartEvictions(0)
+		, StageFootsteps(0)
+		, StageAllocations(0)
+		, RandomStream(0x5F00)
+		, Results(MakeShared<FJsonObject>())
+		, bFinished(false)
+	{
+		// One notify per category, like the different notifies of a walk animation
+		if (const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get())
+		{
+			for (int32 i = 0; i < FootstepSettings->GetCategoriesNum(); ++i)
+			{
+				UAnimNotify_SurfaceFootstep* Notify = NewObject<UAnimNotify_SurfaceFootstep>(GetTransientPackage(), NAME_None, RF_Transient);
+				Notify->FootstepCategory = FootstepSettings->GetCategoryName(i);
+				Notify->bTraceFromFootSocket = false;
+
+				Notifies.Add(Notify);
+			}
+		}
+
+		// Deferred traces and batches would run outside the timed notifies
+		ForceCVar(TEXT("Footstep.AsyncTrace"), 0);
+		ForceCVar(TEXT("Footstep.Batch"), 0);
+	}
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override
+	{
+		UWorld* CurrentWorld = World.Get();
+		if (!(CurrentWorld && TemplateComponent.IsValid()))
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep crowd benchmark has been aborted, because its world or template component is gone."));
+			DestroyCrowd();
+			Finish();
+			return;
+		}
+
+		const double TimeSeconds = CurrentWorld->GetTimeSeconds();
+
+		if (CurrentStage == INDEX_NONE || TimeSeconds - StageStartTime >= StageDuration)
+		{
+			if (CurrentStage != INDEX_NONE)
+			{
+				FinishStage(*CurrentWorld);
+			}
+
+			if (++CurrentStage >= CrowdSizes.Num())
+			{
+				WriteResults();
+				Finish();
+
+				if (bExitWhenDone)
+				{
+					FPlatformMisc::RequestExit(false);
+				}
+				return;
+			}
+
+			StartStage(*CurrentWorld, TimeSeconds);
+			return;
+		}
+
+		FrameTimes.Add(FApp::GetDeltaTime() * 1000.0);
+
+		const uint64 StartAllocations = FootstepBenchmark::GetNumAllocations();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+
+		// Notifies of a looping animation have no event to refer to, so they are treated as fully weighted
+		const FAnimNotifyEventReference EventReference;
+
+		for (FCrowdMember& Member : Crowd)
+		{
+			if (TimeSeconds < Member.NextStepTime || !Member.Mesh.IsValid()) { continue; }
+
+			Notifies[Member.NextCategory++ % Notifies.Num()]->Notify(Member.Mesh.Get(), nullptr, EventReference);
+			Member.NextStepTime += StepInterval;
+			++StageFootsteps;
+		}
+
+		FootstepTimes.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+		StageAllocations += FootstepBenchmark::GetNumAllocations() - StartAllocations;
+	}
+
+	virtual ETickableTickType GetTickableTickType() const override
+	{
+		return ETickableTickType::Always;
+	}
+
+	virtual bool IsTickable() const override
+	{
+		return !bFinished;
+	}
+
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FFootstepCrowdBenchmark, STATGROUP_Tickables);
+	}
+	//~ End FTickableGameObject Interface
+
+	//~ Begin FGCObject Interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	{
+		Collector.AddReferencedObjects(Notifies);
+	}
+
+	virtual FString GetReferencerName() const override
+	{
+		return TEXT("FFootstepCrowdBenchmark");
+	}
+	//~ End FGCObject Interface
+
+	bool IsFinished() const
+	{
+		return bFinished;
+	}
+
+private:
+	struct FCrowdMember
+	{
+		TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+		double NextStepTime = 0.0;
+		int32 NextCategory = 0;
+	};
+
+	TWeakObjectPtr<UWorld> World;
+	TWeakObjectPtr<UFootstepComponent> TemplateComponent;
+	TArray<int32> CrowdSizes;
+	float StageDuration;
+	float StepInterval;
+	bool bExitWhenDone;
+
+	int32 CurrentStage;
+	double StageStartTime;
+	uint64 StageStartAllocations;
+	int32 StageStartEvictions;
+	int32 StageFootsteps;
+	uint64 StageAllocations;
+
+	TArray<FCrowdMember> Crowd;
+	TArray<TWeakObjectPtr<AActor>> CrowdActors;
+	TArray<TObjectPtr<UAnimNotify_SurfaceFootstep>> Notifies;
+	TArray<double> FrameTimes;
+	TArray<double> FootstepTimes;
+	FRandomStream RandomStream;
+
+	TSharedRef<FJsonObject> Results;
+	TArray<TSharedPtr<FJsonValue>> StageResults;
+	bool bFinished;
+
+	/** CVars changed for the run, with their previous values. */
+	TArray<TPair<IConsoleVariable*, FString>> ForcedCVars;
+
+	/** Sets the CVar with the priority it has been set with, so the previous value can be restored without raising its priority. */
+	void ForceCVar(const TCHAR* Name, int32 Value)
+	{
+		if (IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			ForcedCVars.Emplace(CVar, CVar->GetString());
+			CVar->Set(Value, static_cast<EConsoleVariableFlags>(CVar->GetFlags() & ECVF_SetByMask));
+		}
+	}
+
+	void RestoreCVars()
+	{
+		for (const TPair<IConsoleVariable*, FString>& ForcedCVar : ForcedCVars)
+		{
+			ForcedCVar.Key->Set(*ForcedCVar.Value, static_cast<EConsoleVariableFlags>(ForcedCVar.Key->GetFlags() & ECVF_SetByMask));
+		}
+
+		ForcedCVars.Reset();
+	}
+
+	static FVector GetCrowdOrigin(UWorld& InWorld)
+	{
+		FVector Origin = FVector::ZeroVector;
+
+		if (const APlayerController* PlayerController = InWorld.GetFirstPlayerController())
+		{
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(Origin, ViewRotation);
+		}
+
+		// Start at the floor below the view, so every trace has a chance to hit something
+		FHitResult HitResult;
+		if (InWorld.LineTraceSingleByChannel(HitResult, Origin, Origin - FVector(0.0, 0.0, 100000.0), ECC_WorldStatic))
+		{
+			Origin = HitResult.ImpactPoint;
+		}
+
+		return Origin;
+	}
+
+	void StartStage(UWorld& InWorld, double TimeSeconds)
+	{
+		const int32 CrowdSize = CrowdSizes[CurrentStage];
+		const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(CrowdSize)));
+		constexpr double Spacing = 150.0;
+		const FVector Origin = GetCrowdOrigin(InWorld) - FVector(GridSize * Spacing * 0.5, GridSize * Spacing * 0.5, 0.0);
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		Crowd.Reserve(CrowdSize);
+		CrowdActors.Reserve(CrowdSize);
+
+		for (int32 i = 0; i < CrowdSize; ++i)
+		{
+			const FVector Location = Origin + FVector((i % GridSize) * Spacing, (i / GridSize) * Spacing, 20.0);
+
+			AFootstepBenchmarkActor* Actor = InWorld.SpawnActor<AFootstepBenchmarkActor>(AFootstepBenchmarkActor::StaticClass(), FTransform(Location), SpawnParams);
+			if (!Actor) { continue; }
+
+			Actor->InitFootstepComponent(TemplateComponent.Get());
+
+			FCrowdMember& Member = Crowd.AddDefaulted_GetRef();
+			Member.Mesh = Actor->GetMeshComponent();
+			Member.NextStepTime = TimeSeconds + RandomStream.FRandRange(0.f, StepInterval);
+			Member.NextCategory = RandomStream.RandHelper(Notifies.Num());
+
+			CrowdActors.Add(Actor);
+		}
+
+		FrameTimes.Reset();
+		FootstepTimes.Reset();
+		StageStartTime = TimeSeconds;
+		StageStartAllocations = FootstepBenchmark::GetNumAllocations();
+		StageStartEvictions = UFootstepPoolingManager::GetFootstepPoolStats(&InWorld).TotalEvictions;
+		StageFootsteps = 0;
+		StageAllocations = 0;
+
+		UE_LOG(LogFootstep, Display, TEXT("Footstep crowd benchmark: running %d characters for %.1f s."), CrowdSize, StageDuration);
+	}
+
+	void FinishStage(UWorld& InWorld)
+	{
+		const FFootstepPoolStats PoolStats = UFootstepPoolingManager::GetFootstepPoolStats(&InWorld);
+
+		TSharedRef<FJsonObject> StageObject = MakeShared<FJsonObject>();
+		StageObject->SetNumberField(TEXT("characters"), CrowdSizes[CurrentStage]);
+		StageObject->SetNumberField(TEXT("frames"), FootstepTimes.Num());
+		StageObject->SetNumberField(TEXT("footsteps"), StageFootsteps);
+		StageObject->SetObjectField(TEXT("footstep_ms_per_frame"), FootstepBenchmark::MakeFrameCostObject(FootstepTimes));
+		StageObject->SetObjectField(TEXT("frame_ms"), FootstepBenchmark::MakeFrameCostObject(FrameTimes));
+		FootstepBenchmark::SetAllocationField(*StageObject, TEXT("footstep_allocations"), static_cast<double>(StageAllocations));
+		FootstepBenchmark::SetAllocationField(*StageObject, TEXT("footstep_allocations_per_step"), StageFootsteps > 0 ? static_cast<double>(StageAllocations) / StageFootsteps : 0.0);
+		FootstepBenchmark::SetAllocationField(*StageObject, TEXT("game_thread_allocations"), static_cast<double>(FootstepBenchmark::GetNumAllocations() - StageStartAllocations));
+		StageObject->SetNumberField(TEXT("pool_evictions"), PoolStats.TotalEvictions - StageStartEvictions);
+		StageObject->SetNumberField(TEXT("pool_size"), PoolStats.PoolSize);
+		StageObject->SetNumberField(TEXT("pool_high_water_mark"), PoolStats.HighWaterMark);
+
+		StageResults.Add(MakeShared<FJsonValueObject>(StageObject));
+
+		DestroyCrowd();
+	}
+
+	void DestroyCrowd()
+	{
+		for (const TWeakObjectPtr<AActor>& Actor : CrowdActors)
+		{
+			if (Actor.IsValid())
+			{
+				Actor->Destroy();
+			}
+		}
+
+		CrowdActors.Reset();
+		Crowd.Reset();
+	}
+
+	void WriteResults()
+	{
+		Results->SetStringField(TEXT("map"), World.IsValid() ? World->GetMapName() : FString());
+		Results->SetStringField(TEXT("build"), LexToString(FApp::GetBuildConfiguration()));
+		Results->SetNumberField(TEXT("stage_duration"), StageDuration);
+		Results->SetNumberField(TEXT("step_interval"), StepInterval);
+		Results->SetObjectField(TEXT("cvars"), FootstepBenchmark::MakeCVarsObject());
+		Results->SetArrayField(TEXT("stages"), StageResults);
+
+		FootstepBenchmark::SaveResults(TEXT("CrowdBenchmark"), Results);
+	}
+
+	void Finish();
+};
+
+static TUniquePtr<FFootstepCrowdBenchmark> GFootstepCrowdBenchmark;
+
+void FFootstepCrowdBenchmark::Finish()
+{
+	bFinished = true;
+	RestoreCVars();
+
+	// The benchmark can't be destroyed while it's ticking, and a new one may have been started by then
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float)
+	{
+		if (GFootstepCrowdBenchmark.Get() == this)
+		{
+			GFootstepCrowdBenchmark.Reset();
+		}
+		return false;
+	}));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GFootstepCrowdBenchmarkCommand(
+	TEXT("Footstep.Benchmark.Crowd"),
+	TEXT("Runs the footstep crowd benchmark on the current map and writes the results as JSON to the Profiling directory. ")
+	TEXT("Arguments: CrowdSizes (comma separated, default 100,500,2000), StageDuration (default 10 s), StepInterval (default 0.35 s), -exit to quit when done. ")
+	TEXT("Footstep Data Assets are copied from the first Footstep Component found in the world."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (GFootstepCrowdBenchmark.IsValid() && !GFootstepCrowdBenchmark->IsFinished())
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep crowd benchmark is already running."));
+			return;
+		}
+
+		if (!(World && World->IsGameWorld()))
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep crowd benchmark has to be run in a game world."));
+			return;
+		}
+
+		const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+		if (!(FootstepSettings && FootstepSettings->GetCategoriesNum() > 0))
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep crowd benchmark needs at least one Footstep Category in the Surface Footstep System Settings."));
+			return;
+		}
+
+		UFootstepComponent* TemplateComponent = nullptr;
+		for (TActorIterator<AActor> It(World); It && !TemplateComponent; ++It)
+		{
+			TemplateComponent = It->FindComponentByClass<UFootstepComponent>();
+		}
+
+		if (!TemplateComponent)
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep crowd benchmark needs at least one actor with a Footstep Component in the world."));
+			return;
+		}
+
+		TArray<FString> PositionalArgs;
+		bool bExitWhenDone = false;
+		for (const FString& Arg : Args)
+		{
+			if (Arg.Equals(TEXT("-exit"), ESearchCase::IgnoreCase))
+			{
+				bExitWhenDone = true;
+			}
+			else
+			{
+				PositionalArgs.Add(Arg);
+			}
+		}
+
+		TArray<int32> CrowdSizes;
+		if (PositionalArgs.Num() > 0)
+		{
+			TArray<FString> CrowdSizeStrings;
+			PositionalArgs[0].ParseIntoArray(CrowdSizeStrings, TEXT(","));
+
+			for (const FString& CrowdSizeString : CrowdSizeStrings)
+			{
+				const int32 CrowdSize = FCString::Atoi(*CrowdSizeString);
+				if (CrowdSize > 0)
+				{
+					CrowdSizes.Add(CrowdSize);
+				}
+			}
+		}
+
+		if (CrowdSizes.IsEmpty())
+		{
+			CrowdSizes = { 100, 500, 2000 };
+		}
+
+		const float StageDuration = PositionalArgs.Num() > 1 ? FMath::Max(FCString::Atof(*PositionalArgs[1]), 1.f) : 10.f;
+		const float StepInterval = PositionalArgs.Num() > 2 ? FMath::Max(FCString::Atof(*PositionalArgs[2]), 0.01f) : 0.35f;
+
+		FootstepBenchmark::WarnIfAllocationsNotCounted();
+
+		GFootstepCrowdBenchmark = MakeUnique<FFootstepCrowdBenchmark>(World, TemplateComponent, MoveTemp(CrowdSizes), StageDuration, StepInterval, bExitWhenDone);
+	})
+);
+
+
+/**
+ * Replays a footstep recording into the Footstep Pooling Manager of the current world, without animation, traces or surface lookup.
+ * Footsteps play at their recorded time, or one recorded frame per tick with -fast, so pool and eviction strategies can be compared on the same load.
+ * The results are written as JSON to the Profiling directory.
+ */
+class FFootstepReplay : public FTickableGameObject, public FGCObject
+{
+public:
+	FFootstepReplay(UWorld* InWorld, FFootstepRecording&& InRecording, const FString& InRecordingName, bool bInFast, bool bInExitWhenDone)
+		: World(InWorld)
+		, Recording(MoveTemp(InRecording))
+		, RecordingName(InRecordingName)
+		, bFast(bInFast)
+		, bExitWhenDone(bInExitWhenDone)
+		, NextRecord(0)
+		, StartTime(-1.0)
+		, StartAllocations(0)
+		, StartEvictions(0)
+		, ReplayAllocations(0)
+		, bFinished(false)
+	{
+		// Load everything up front, so the replay measures only the FX side
+		Objects.SetNum(Recording.Names.Num());
+		Categories.SetNum(Recording.Names.Num());
+
+		for (const FFootstepRecord& Record : Recording.Records)
+		{
+			LoadObjectAt(Record.DataAsset);
+			LoadObjectAt(Record.Sound);
+			LoadObjectAt(Record.Particle);
+
+			if (Categories.IsValidIndex(Record.Category) && !Categories[Record.Category].IsValid())
+			{
+				Categories[Record.Category] = FGameplayTag::RequestGameplayTag(FName(Recording.Names[Record.Category]), false);
+			}
+		}
+	}
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override
+	{
+		UWorld* CurrentWorld = World.Get();
+		UFootstepPoolingManager* PoolingManager = CurrentWorld ? CurrentWorld->GetSubsystem<UFootstepPoolingManager>() : nullptr;
+
+		if (!PoolingManager)
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep replay has been aborted, because its world or Footstep Pooling Manager is gone."));
+			bFinished = true;
+			return;
+		}
+
+		const double TimeSeconds = CurrentWorld->GetTimeSeconds();
+
+		if (StartTime < 0.0)
+		{
+			StartTime = TimeSeconds;
+			StartAllocations = FootstepBenchmark::GetNumAllocations();
+			StartEvictions = UFootstepPoolingManager::GetFootstepPoolStats(CurrentWorld).TotalEvictions;
+
+			UE_LOG(LogFootstep, Display, TEXT("Footstep replay: playing %d footsteps from %s."), Recording.Records.Num(), *RecordingName);
+		}
+
+		FrameTimes.Add(FApp::GetDeltaTime() * 1000.0);
+
+		const uint64 StartFrameAllocations = FootstepBenchmark::GetNumAllocations();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+
+		const double ElapsedTime = TimeSeconds - StartTime;
+		const uint32 ReplayFrame = Recording.Records.IsValidIndex(NextRecord) ? Recording.Records[NextRecord].Frame : 0;
+
+		while (Recording.Records.IsValidIndex(NextRecord))
+		{
+			const FFootstepRecord& Record = Recording.Records[NextRecord];
+			if (bFast ? Record.Frame != ReplayFrame : Record.Time > ElapsedTime) { break; }
+
+			PlayFootstep(*PoolingManager, Record);
+			++NextRecord;
+		}
+
+		FootstepTimes.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+		ReplayAllocations += FootstepBenchmark::GetNumAllocations() - StartFrameAllocations;
+
+		if (NextRecord >= Recording.Records.Num())
+		{
+			WriteResults(*CurrentWorld, TimeSeconds);
+			bFinished = true;
+
+			if (bExitWhenDone)
+			{
+				FPlatformMisc::RequestExit(false);
+			}
+		}
+	}
+
+	virtual ETickableTickType GetTickableTickType() const override
+	{
+		return ETickableTickType::Always;
+	}
+
+	virtual bool IsTickable() const override
+	{
+		return !bFinished;
+	}
+
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FFootstepReplay, STATGROUP_Tickables);
+	}
+	//~ End FTickableGameObject Interface
+
+	//~ Begin FGCObject Interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	{
+		Collector.AddReferencedObjects(Objects);
+	}
+
+	virtual FString GetReferencerName() const override
+	{
+		return TEXT("FFootstepReplay");
+	}
+	//~ End FGCObject Interface
+
+	bool IsFinished() const
+	{
+		return bFinished;
+	}
+
+private:
+	TWeakObjectPtr<UWorld> World;
+	FFootstepRecording Recording;
+	FString RecordingName;
+	bool bFast;
+	bool bExitWhenDone;
+
+	int32 NextRecord;
+	double StartTime;
+	uint64 StartAllocations;
+	int32 StartEvictions;
+	uint64 ReplayAllocations;
+
+	TArray<TObjectPtr<UObject>> Objects;
+	TArray<FGameplayTag> Categories;
+	TArray<double> FrameTimes;
+	TArray<double> FootstepTimes;
+	bool bFinished;
+
+	void LoadObjectAt(int32 Index)
+	{
+		if (!Objects.IsValidIndex(Index) || Objects[Index]) { return; }
+
+		Objects[Index] = LoadObject<UObject>(nullptr, *Recording.Names[Index]);
+
+		if (!Objects[Index])
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep replay couldn't load %s."), *Recording.Names[Index]);
+		}
+	}
+
+	template<typename T>
+	T* GetObjectAt(int32 Index) const
+	{
+		return Objects.IsValidIndex(Index) ? Cast<T>(Objects[Index]) : nullptr;
+	}
+
+	void PlayFootstep(UFootstepPoolingManager& PoolingManager, const FFootstepRecord& Record) const
+	{
+		const UFootstepDataAsset* FootstepData = GetObjectAt<UFootstepDataAsset>(Record.DataAsset);
+		if (!FootstepData) { return; }
+
+		USoundBase* FootstepSound = GetObjectAt<USoundBase>(Record.Sound);
+		UFXSystemAsset* FootstepParticle = GetObjectAt<UFXSystemAsset>(Record.Particle);
+		const FGameplayTag FootstepCategory = Categories.IsValidIndex(Record.Category) ? Categories[Record.Category] : FGameplayTag();
+		const FVector Location(Record.Location);
+		const FVector Normal(Record.Normal);
+
+		if (FootstepScalability::GetSpawnParticles())
+		{
+			if (UNiagaraDataChannelAsset* FootstepDataChannel = FootstepData->GetNiagaraDataChannel(FootstepCategory))
+			{
+				PoolingManager.AddDataChannelFootstep(FootstepDataChannel, FootstepData->GetNiagaraDataChannelSystem(FootstepCategory), Location, Normal, Record.ParticleScale.X);
+			}
+		}
+
+		if (!(FootstepSound || FootstepParticle)) { return; }
+
+		PoolingManager.SafeSpawnPooledActor();
+
+		constexpr bool bRemoveInvalidActors = false;
+		if (AFootstepActor* FootstepActor = PoolingManager.GetPooledActor(bRemoveInvalidActors))
+		{
+			FootstepActor->SetPoolingActive(false);
+			FootstepActor->SetActorTransform(FTransform(FRotationMatrix::MakeFromZ(Normal).ToQuat(), Location, FVector::OneVector));
+
+			USoundAttenuation* AttenuationOverride = FootstepSound ? FootstepData->GetAttenuationOverride() : nullptr;
+			USoundConcurrency* ConcurrencyOverride = FootstepSound ? FootstepData->GetConcurrencyOverride() : nullptr;
+
+			FootstepActor->InitSound(FootstepSound, Record.Volume, Record.Pitch, Record.bPlaySound2D, AttenuationOverride, ConcurrencyOverride);
+			FootstepActor->InitParticle(FootstepParticle, FVector(Record.ParticleScale));
+
+			PoolingManager.ActivatePooledActor(FootstepActor, FootstepData->GetFootstepLifeSpan());
+		}
+	}
+
+	void WriteResults(UWorld& InWorld, double TimeSeconds)
+	{
+		const FFootstepPoolStats PoolStats = UFootstepPoolingManager::GetFootstepPoolStats(&InWorld);
+
+		TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+		Results->SetStringField(TEXT("recording"), RecordingName);
+		Results->SetStringField(TEXT("map"), InWorld.GetMapName());
+		Results->SetStringField(TEXT("build"), LexToString(FApp::GetBuildConfiguration()));
+		Results->SetStringField(TEXT("mode"), bFast ? TEXT("fast") : TEXT("timed"));
+		Results->SetObjectField(TEXT("cvars"), FootstepBenchmark::MakeCVarsObject());
+		Results->SetNumberField(TEXT("duration"), TimeSeconds - StartTime);
+		Results->SetNumberField(TEXT("frames"), FootstepTimes.Num());
+		Results->SetNumberField(TEXT("footsteps"), Recording.Records.Num());
+		Results->SetObjectField(TEXT("footstep_ms_per_frame"), FootstepBenchmark::MakeFrameCostObject(FootstepTimes));
+		Results->SetObjectField(TEXT("frame_ms"), FootstepBenchmark::MakeFrameCostObject(FrameTimes));
+		FootstepBenchmark::SetAllocationField(*Results, TEXT("footstep_allocations"), static_cast<double>(ReplayAllocations));
+		FootstepBenchmark::SetAllocationField(*Results, TEXT("game_thread_allocations"), static_cast<double>(FootstepBenchmark::GetNumAllocations() - StartAllocations));
+		Results->SetNumberField(TEXT("pool_evictions"), PoolStats.TotalEvictions - StartEvictions);
+		Results->SetNumberField(TEXT("pool_size"), PoolStats.PoolSize);
+		Results->SetNumberField(TEXT("pool_high_water_mark"), PoolStats.HighWaterMark);
+
+		FootstepBenchmark::SaveResults(TEXT("Replay"), Results);
+	}
+};
+
+static TUniquePtr<FFootstepReplay> GFootstepReplay;
+
+static FAutoConsoleCommandWithWorldAndArgs GFootstepReplayCommand(
+	TEXT("Footstep.Replay"),
+	TEXT("Replays a footstep recording made with Footstep.Record.Start into the footstep pool of the current world and writes the results as JSON to the Profiling directory. ")
+	TEXT("Arguments: FileName (relative to the Profiling/Footstep directory), -fast to play one recorded frame per tick instead of the recorded timing, -exit to quit when done."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (GFootstepReplay.IsValid() && !GFootstepReplay->IsFinished())
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep replay is already running."));
+			return;
+		}
+
+		if (!(World && World->IsGameWorld() && World->GetSubsystem<UFootstepPoolingManager>()))
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep replay has to be run in a game world with a Footstep Pooling Manager."));
+			return;
+		}
+
+		FString FileName;
+		bool bFast = false;
+		bool bExitWhenDone = false;
+		for (const FString& Arg : Args)
+		{
+			if (Arg.Equals(TEXT("-fast"), ESearchCase::IgnoreCase))
+			{
+				bFast = true;
+			}
+			else if (Arg.Equals(TEXT("-exit"), ESearchCase::IgnoreCase))
+			{
+				bExitWhenDone = true;
+			}
+			else
+			{
+				FileName = Arg;
+			}
+		}
+
+		const FString FilePath = FPaths::IsRelative(FileName) ? FPaths::ProfilingDir() / TEXT("Footstep") / FileName : FileName;
+
+		FFootstepRecording Recording;
+		if (FileName.IsEmpty() || !Recording.Load(FilePath))
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Couldn't read the footstep recording %s."), *FilePath);
+			return;
+		}
+
+		FootstepBenchmark::WarnIfAllocationsNotCounted();
+
+		GFootstepReplay = MakeUnique<FFootstepReplay>(World, MoveTemp(Recording), FPaths::GetCleanFilename(FilePath), bFast, bExitWhenDone);
+	})
+);
+
+
+/**
+ * Measures the hot paths of the footstep pipeline in isolation, on transient objects, so the results don't depend on the map or the project content.
+ * Every kernel reports nanoseconds and allocations per operation.
+ */
+class FFootstepKernelBenchmark
+{
+public:
+	static TSharedRef<FJsonObject> Run(UWorld* World, int32 Iterations)
+	{
+		FootstepBenchmark::WarnIfAllocationsNotCounted();
+
+		TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+		TArray<TSharedPtr<FJsonValue>> KernelResults;
+
+		const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+		const FGameplayTag Category = FootstepSettings ? FootstepSettings->GetCategoryName(0) : FGameplayTag();
+
+		if (UFootstepPoolingManager* PoolingManager = World ? World->GetSubsystem<UFootstepPoolingManager>() : nullptr)
+		{
+			for (const int32 MaxPoolSize : { 8, 32, 128 })
+			{
+				MeasurePoolChurn(*PoolingManager, MaxPoolSize, Iterations, KernelResults);
+			}
+		}
+		else
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep kernel benchmark: the pool kernels need a game world with a Footstep Pooling Manager and have been skipped."));
+		}
+
+		if (Category.IsValid())
+		{
+			for (const int32 NumVariants : { 1, 16, 256 })
+			{
+				const UFootstepDataAsset* DataAsset = MakeDataAsset(Category, NumVariants);
+
+				Measure(KernelResults, TEXT("UFootstepDataAsset::GetSound"), FString::Printf(TEXT("Variants=%d"), NumVariants), Iterations, [DataAsset, &Category](int32 NumOps)
+				{
+					for (int32 i = 0; i < NumOps; ++i)
+					{
+						Consume(DataAsset->GetSound(Category));
+					}
+				});
+
+				Measure(KernelResults, TEXT("UFootstepDataAsset::GetParticle"), FString::Printf(TEXT("Variants=%d"), NumVariants), Iterations, [DataAsset, &Category](int32 NumOps)
+				{
+					for (int32 i = 0; i < NumOps; ++i)
+					{
+						Consume(DataAsset->GetParticle(Category));
+					}
+				});
+			}
+
+			const UFootstepComponent* FootstepComponent = MakeFootstepComponent(MakeDataAsset(Category, 1));
+
+			Measure(KernelResults, TEXT("UFootstepComponent::GetFootstepData"), FString::Printf(TEXT("SurfaceTypes=%d"), static_cast<int32>(SurfaceType_Max)), Iterations, [FootstepComponent](int32 NumOps)
+			{
+				for (int32 i = 0; i < NumOps; ++i)
+				{
+					Consume(FootstepComponent->GetFootstepData(static_cast<EPhysicalSurface>(i % SurfaceType_Max)));
+				}
+			});
+		}
+		else
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footstep kernel benchmark: the Data Asset kernels need at least one footstep category and have been skipped."));
+		}
+
+		for (const int32 NumCategories : { 8, 64, 512 })
+		{
+			const USurfaceFootstepSystemSettings* Settings = MakeSettings(NumCategories);
+			if (!Settings) { break; }
+
+			// A missing category is the worst case of the linear search
+			const FGameplayTag MissingCategory;
+
+			Measure(KernelResults, TEXT("USurfaceFootstepSystemSettings::ContainsCategory"), FString::Printf(TEXT("Categories=%d"), NumCategories), Iterations, [Settings, &MissingCategory](int32 NumOps)
+			{
+				for (int32 i = 0; i < NumOps; ++i)
+				{
+					Consume(Settings->ContainsCategory(MissingCategory));
+				}
+			});
+		}
+
+		Results->SetNumberField(TEXT("iterations"), Iterations);
+		Results->SetStringField(TEXT("build"), LexToString(FApp::GetBuildConfiguration()));
+		Results->SetArrayField(TEXT("kernels"), KernelResults);
+
+		return Results;
+	}
+
+private:
+	/** Keeps the optimizer from removing the measured calls. */
+	static inline volatile UPTRINT Sink = 0;
+
+	template<typename T>
+	static void Consume(const T& Value)
+	{
+		Sink = Sink + static_cast<UPTRINT>(reinterpret_cast<const uint8&>(Value));
+	}
+
+	template<typename T>
+	static void Consume(T* Value)
+	{
+		Sink = Sink + reinterpret_cast<UPTRINT>(Value);
+	}
+
+	static void Measure(TArray<TSharedPtr<FJsonValue>>& OutResults, const TCHAR* KernelName, const FString& Params, int32 Iterations, TFunctionRef<void(int32)> Kernel)
+	{
+		// Warm up caches and lazily created data
+		Kernel(FMath::Min(Iterations, 1000));
+
+		const uint64 StartAllocations = FootstepBenchmark::GetNumAllocations();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+
+		Kernel(Iterations);
+
+		const double NsPerOp = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000000.0 / Iterations;
+		const double AllocationsPerOp = static_cast<double>(FootstepBenchmark::GetNumAllocations() - StartAllocations) / Iterations;
+
+		UE_LOG(LogFootstep, Display, TEXT("%s (%s): %.1f ns/op, %.3f allocations/op"), KernelName, *Params, NsPerOp, AllocationsPerOp);
+
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("kernel"), KernelName);
+		Object->SetStringField(TEXT("params"), Params);
+		Object->SetNumberField(TEXT("ns_per_op"), NsPerOp);
+		FootstepBenchmark::SetAllocationField(*Object, TEXT("allocations_per_op"), AllocationsPerOp);
+
+		OutResults.Add(MakeShared<FJsonValueObject>(Object));
+	}
+
+	static void MeasurePoolChurn(UFootstepPoolingManager& PoolingManager, int32 MaxPoolSize, int32 Iterations, TArray<TSharedPtr<FJsonValue>>& OutResults)
+	{
+		// Any loaded assets will do, they only have to give the actors something to activate
+		TObjectIterator<USoundBase> SoundIt;
+		TObjectIterator<UNiagaraSystem> NiagaraIt;
+		USoundBase* Sound = SoundIt ? *SoundIt : nullptr;
+		UNiagaraSystem* Particle = NiagaraIt ? *NiagaraIt : nullptr;
+
+		// Set like a quality level would, and restored afterwards. A value set with a higher priority, e.g. from the console, wins and is reported as the pool limit
+		IConsoleVariable* MaxPoolSizeCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Footstep.MaxPoolSize"));
+		if (!MaxPoolSizeCVar) { return; }
+
+		const int32 PreviousMaxPoolSize = MaxPoolSizeCVar->GetInt();
+		MaxPoolSizeCVar->Set(MaxPoolSize, ECVF_SetByScalability);
+
+		UFootstepPoolingManager::DestroyFootstepPool(&PoolingManager);
+
+		// Every acquired actor stays active until it's reused, so the pool fills up and then keeps evicting
+		Measure(OutResults, TEXT("UFootstepPoolingManager::SafeSpawnPooledActor+GetPooledActor+ActivatePooledActor"), FString::Printf(TEXT("MaxPoolSize=%d, PoolLimit=%d, Sound=%d, Particle=%d"), MaxPoolSize, PoolingManager.GetPoolLimit(), Sound != nullptr, Particle != nullptr), Iterations, [&PoolingManager, Sound, Particle](int32 NumOps)
+		{
+			constexpr bool bRemoveInvalidActors = false;
+			constexpr bool bIs2D = false;
+			for (int32 i = 0; i < NumOps; ++i)
+			{
+				PoolingManager.SafeSpawnPooledActor();
+
+				AFootstepActor* FootstepActor = PoolingManager.GetPooledActor(bRemoveInvalidActors);
+				if (!FootstepActor) { continue; }
+
+				FootstepActor->SetPoolingActive(false);
+				FootstepActor->InitSound(Sound, 1.f, 1.f, bIs2D);
+				FootstepActor->InitParticle(Particle, FVector::OneVector);
+
+				PoolingManager.ActivatePooledActor(FootstepActor, 0.f);
+			}
+		});
+
+		UFootstepPoolingManager::DestroyFootstepPool(&PoolingManager);
+		MaxPoolSizeCVar->Set(PreviousMaxPoolSize, ECVF_SetByScalability);
+	}
+
+	static UFootstepDataAsset* MakeDataAsset(const FGameplayTag& Category, int32 NumVariants)
+	{
+		UFootstepDataAsset* DataAsset = NewObject<UFootstepDataAsset>(GetTransientPackage());
+
+		// Any loaded assets will do, they're only resolved
+		TObjectIterator<USoundBase> SoundIt;
+		TObjectIterator<UNiagaraSystem> NiagaraIt;
+
+		FFootstepData Data;
+		for (int32 i = 0; i < NumVariants; ++i)
+		{
+			Data.Sounds.Add(SoundIt ? *SoundIt : nullptr);
+			Data.NiagaraParticles.Add(NiagaraIt ? *NiagaraIt : nullptr);
+		}
+
+		// Footstep Data is protected, so it's filled through reflection like the editor would do
+		if (const FMapProperty* FootstepDataProperty = FindFProperty<FMapProperty>(UFootstepDataAsset::StaticClass(), TEXT("FootstepData")))
+		{
+			FootstepDataProperty->ContainerPtrToValuePtr<TMap<FGameplayTag, FFootstepData>>(DataAsset)->Add(Category, MoveTemp(Data));
+		}
+
+		return DataAsset;
+	}
+
+	static UFootstepComponent* MakeFootstepComponent(UFootstepDataAsset* DataAsset)
+	{
+		UFootstepComponent* FootstepComponent = NewObject<UFootstepComponent>(GetTransientPackage());
+
+		if (const FMapProperty* FootstepFXesProperty = FindFProperty<FMapProperty>(UFootstepComponent::StaticClass(), TEXT("FootstepFXes")))
+		{
+			TMap<TEnumAsByte<EPhysicalSurface>, TSoftObjectPtr<UFootstepDataAsset>>& FootstepFXes = *FootstepFXesProperty->ContainerPtrToValuePtr<TMap<TEnumAsByte<EPhysicalSurface>, TSoftObjectPtr<UFootstepDataAsset>>>(FootstepComponent);
+
+			for (int32 i = 0; i < SurfaceType_Max; ++i)
+			{
+				FootstepFXes.Add(static_cast<EPhysicalSurface>(i), DataAsset);
+			}
+		}
+
+		return FootstepComponent;
+	}
+
+	static USurfaceFootstepSystemSettings* MakeSettings(int32 NumCategories)
+	{
+		FGameplayTagContainer AllTags;
+		UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, false);
+
+		if (AllTags.IsEmpty()) { return nullptr; }
+
+		USurfaceFootstepSystemSettings* Settings = NewObject<USurfaceFootstepSystemSettings>(GetTransientPackage());
+
+		if (const FArrayProperty* CategoriesProperty = FindFProperty<FArrayProperty>(USurfaceFootstepSystemSettings::StaticClass(), TEXT("FootstepCategories")))
+		{
+			TArray<FGameplayTag>& Categories = *CategoriesProperty->ContainerPtrToValuePtr<TArray<FGameplayTag>>(Settings);
+			Categories.Reset(NumCategories);
+
+			// Repeats registered tags if there aren't enough of them, the search costs the same
+			for (int32 i = 0; i < NumCategories; ++i)
+			{
+				Categories.Add(AllTags.GetByIndex(i % AllTags.Num()));
+			}
+		}
+
+		return Settings;
+	}
+};
+
+static FAutoConsoleCommandWithWorldAndArgs GFootstepKernelBenchmarkCommand(
+	TEXT("Footstep.Benchmark.Kernels"),
+	TEXT("Runs micro-benchmarks of the pool, Data Asset selection, surface lookup and category lookup, and writes ns/op and allocations/op as JSON to the Profiling directory. ")
+	TEXT("Arguments: Iterations (default 100000). The footstep pool of the current world is destroyed by the pool kernels."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+
+		FootstepBenchmark::SaveResults(TEXT("KernelBenchmark"), FFootstepKernelBenchmark::Run(World, Iterations));
+	})
+);
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFootstepKernelBenchmarkTest, "SurfaceFootstepSystem.Benchmark.Kernels", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FFootstepKernelBenchmarkTest::RunTest(const FString& Parameters)
+{
+	if (!TestNotNull(TEXT("Engine"), GEngine)) { return false; }
+
+	// A world of its own, so the pool kernels don't destroy the pool of a running game
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("FootstepKernelBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+
+	const TSharedRef<FJsonObject> Results = FFootstepKernelBenchmark::Run(World, 10000);
+
+	const TArray<TSharedPtr<FJsonValue>>* KernelResults = nullptr;
+	TestTrue(TEXT("Footstep kernels have been measured"), Results->TryGetArrayField(TEXT("kernels"), KernelResults) && KernelResults->Num() > 0);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif
+
+#endif
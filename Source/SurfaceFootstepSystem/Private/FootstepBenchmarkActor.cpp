@@ -0,0 +1,32 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootstepBenchmarkActor.h"
+#include "FootstepComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+
+AFootstepBenchmarkActor::AFootstepBenchmarkActor(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	MeshComponent = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("MeshComponent"));
+	MeshComponent->PrimaryComponentTick.bCanEverTick = false;
+	MeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetRootComponent(MeshComponent);
+}
+
+UFootstepComponent* AFootstepBenchmarkActor::GetFootstepComponent_Implementation() const
+{
+	return FootstepComponent;
+}
+
+void AFootstepBenchmarkActor::InitFootstepComponent(UFootstepComponent* TemplateComponent)
+{
+	FootstepComponent = NewObject<UFootstepComponent>(this, UFootstepComponent::StaticClass(), NAME_None, RF_Transient, TemplateComponent);
+	FootstepComponent->RegisterComponent();
+}
+
+USkeletalMeshComponent* AFootstepBenchmarkActor::GetMeshComponent() const
+{
+	return MeshComponent;
+}
@@ -0,0 +1,38 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "FootstepInterface.h"
+#include "FootstepBenchmarkActor.generated.h"
+
+class USkeletalMeshComponent;
+class UFootstepComponent;
+
+/**
+ * A crowd member of the footstep crowd benchmark. It has a mesh without a skeletal mesh asset, so Surface Footstep notifies can be fired on it
+ * without any animation or skinning cost.
+ */
+UCLASS(Transient, NotPlaceable, NotBlueprintable, NotBlueprintType)
+class AFootstepBenchmarkActor final : public AActor, public IFootstepInterface
+{
+	GENERATED_UCLASS_BODY()
+
+private:
+	UPROPERTY()
+	TObjectPtr<USkeletalMeshComponent> MeshComponent;
+
+	UPROPERTY()
+	TObjectPtr<UFootstepComponent> FootstepComponent;
+
+public:
+	//~ Begin IFootstepInterface Interface
+	virtual UFootstepComponent* GetFootstepComponent_Implementation() const override;
+	//~ End IFootstepInterface Interface
+
+	/** Creates the Footstep Component from the template, so crowd members are set up like the character they stand in for. */
+	void InitFootstepComponent(UFootstepComponent* TemplateComponent);
+
+	USkeletalMeshComponent* GetMeshComponent() const;
+};
@@ -2,13 +2,27 @@
 
 #include "FootstepComponent.h"
 #include "FootstepDataAsset.h"
+#include "FootstepActor.h"
+#include "FootstepPoolingManager.h"
+#include "FootprintManager.h"
+#include "FootstepEventSubsystem.h"
+#include "FootstepBatchManager.h"
+#include "FootstepScalability.h"
+#include "FootstepRecording.h"
 #include "SurfaceFootstepSystemSettings.h"
+#include "Engine/Engine.h"
 #include "Engine/AssetManager.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/Controller.h"
 #include "Engine/World.h"
+#include "TimerManager.h"
 #include "CollisionQueryParams.h"
 #include "DrawDebugHelpers.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Sound/SoundBase.h"
+#include "Components/AudioComponent.h"
+#include "NiagaraDataChannel.h"
 
 #if ENABLE_DRAW_DEBUG
 #include "KismetTraceUtils.h"
@@ -27,6 +41,9 @@ UFootstepComponent::UFootstepComponent(const FObjectInitializer& ObjectInitializ
 	{
 		TraceLength = FootstepSettings->GetDefaultTraceLength();
 	}
+
+	AsyncTraceDelegate.BindUObject(this, &UFootstepComponent::OnAsyncTraceCompleted);
+	PreparedTraceDelegate.BindUObject(this, &UFootstepComponent::OnPreparedTraceCompleted);
 }
 
 void UFootstepComponent::OnRegister()
@@ -39,6 +56,20 @@ void UFootstepComponent::OnRegister()
 void UFootstepComponent::OnUnregister()
 {
 	CancelPreloading();
+	PendingTraces.Reset();
+	PreparedTraces.Reset();
+	DelayedFootsteps.Reset();
+
+	if (const UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(DelayedFootstepsTimer);
+	}
+
+	if (VoiceComponent)
+	{
+		VoiceComponent->DestroyComponent();
+		VoiceComponent = nullptr;
+	}
 	
 	Super::OnUnregister();
 }
@@ -100,44 +131,281 @@ bool UFootstepComponent::RemoveActorToIgnoreForTrace(AActor* ActorToRemove)
 	return false;
 }
 
-bool UFootstepComponent::CreateFootstepLineTrace(const FVector& Start, const FVector& DirectionNormalVector, FHitResult& OutHit) const
+void UFootstepComponent::RequestFootstep(const FFootstepRequest& Request)
 {
-	if (!GetWorld() && !FootstepSettings) { return false; }
+	LLM_SCOPE_BYTAG(Footstep);
 
 	UWorld* World = GetWorld();
+	const AActor* Owner = GetOwner();
 
-	const FVector DirVector = DirectionNormalVector.GetSafeNormal();
-	const FVector End = Start + (DirVector * TraceLength);
+	if (!(World && Owner && FootstepSettings)) { return; }
 
-	const FCollisionQueryParams QueryParams = Invoke([this, World]()->FCollisionQueryParams const {
-		FCollisionQueryParams Params;
-		Params.bReturnPhysicalMaterial = true;
-		Params.bTraceComplex = FootstepSettings->GetTraceComplex();
-		Params.AddIgnoredActor(GetOwner());
-		Params.AddIgnoredActors(ActorsToIgnore);
+	if (CoalesceFootstep(Request)) { return; }
 
-#if ENABLE_DRAW_DEBUG
-		if (bShowDebug)
+	// Notifies of a throttled mesh come in bursts, so they are spread back to their spacing on the notify timeline
+	if (Request.bThrottled && DelayThrottledFootstep(Request)) { return; }
+
+	ResolveFootstep(Request);
+}
+
+void UFootstepComponent::RequestFootsteps(TConstArrayView<FFootstepRequest> Requests, bool bMergeSameSurface)
+{
+	LLM_SCOPE_BYTAG(Footstep);
+
+	UWorld* World = GetWorld();
+	const AActor* Owner = GetOwner();
+
+	if (!(World && Owner && FootstepSettings)) { return; }
+
+	UFootstepPoolingManager* PoolingManager = World->GetSubsystem<UFootstepPoolingManager>();
+	const UFootstepEventSubsystem* EventSubsystem = World->GetSubsystem<UFootstepEventSubsystem>();
+	const bool bGenerateEvents = EventSubsystem && EventSubsystem->ShouldGenerateEvents(this);
+
+	// The Batch Manager already resolves all footsteps of the frame together
+	UFootstepBatchManager* BatchManager = FootstepScalability::GetBatch() ? World->GetSubsystem<UFootstepBatchManager>() : nullptr;
+	const bool bAsyncTrace = !BatchManager && FootstepScalability::GetAsyncTrace();
+
+	FCollisionQueryParams QueryParams;
+	FCollisionObjectQueryParams ObjectParams;
+	if (bAsyncTrace)
+	{
+		MakeTraceParams(QueryParams, ObjectParams);
+	}
+
+	// Merged feet are generated together, once the surfaces of all of them are known
+	uint32 MergeGroup = 0;
+	if (bMergeSameSurface && (BatchManager || bAsyncTrace))
+	{
+		// Zero means a footstep which isn't merged
+		if (++LastMergeGroup == 0) { ++LastMergeGroup; }
+		MergeGroup = LastMergeGroup;
+	}
+
+	TArray<EPhysicalSurface, TInlineAllocator<4>> SoundSurfaces;
+
+	for (const FFootstepRequest& Request : Requests)
+	{
+		if (CoalesceFootstep(Request)) { continue; }
+
+		if (Request.bThrottled && DelayThrottledFootstep(Request)) { continue; }
+
+		// Batched footsteps are culled together with their traces
+		if (BatchManager)
+		{
+			BatchManager->AddFootstep(this, Request, bGenerateEvents, MergeGroup);
+			continue;
+		}
+
+		const bool bGenerateFX = PoolingManager && PoolingManager->ShouldGenerateFootstep(Request.TraceStart);
+
+		if (!(bGenerateFX || bGenerateEvents)) { continue; }
+
+		if (bAsyncTrace)
 		{
-			const FName TraceTag = TEXT("Debug");
-			Params.TraceTag = TraceTag;
+			const FVector End = Request.TraceStart + (Request.TraceDirection.GetSafeNormal() * TraceLength);
 
-			World->DebugDrawTraceTag = TraceTag;
+			FFootstepPendingTrace& PendingTrace = PendingTraces.AddDefaulted_GetRef();
+			PendingTrace.Request = Request;
+			PendingTrace.bGenerateFX = bGenerateFX;
+			PendingTrace.MergeGroup = MergeGroup;
+			PendingTrace.TraceHandle = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Request.TraceStart, End, ObjectParams, QueryParams, &AsyncTraceDelegate);
+
+			continue;
 		}
-#endif
 
-		return Params;
+		FHitResult HitResult;
+		const UPhysicalMaterial* PhysMat = ResolveFootstepSurface(Request.TraceStart, Request.TraceDirection, HitResult);
+
+		if (bMergeSameSurface)
+		{
+			GenerateMergedFootstep(Request, HitResult, PhysMat, bGenerateFX, SoundSurfaces);
+		}
+		else if (PhysMat)
+		{
+			GenerateFootstep(Request, HitResult, PhysMat, bGenerateFX);
+		}
+		else
+		{
+			FOOTSTEP_TRACE_FOOTSTEP(Owner, SurfaceType_Default, Request.Category, false, INDEX_NONE, false);
+		}
+	}
+}
+
+void UFootstepComponent::GenerateMergedFootstep(const FFootstepRequest& Request, const FHitResult& HitResult, const UPhysicalMaterial* PhysMat, bool bGenerateFX, TArray<EPhysicalSurface, TInlineAllocator<4>>& SoundSurfaces, const FFootstepVariation* Variation)
+{
+	if (!PhysMat)
+	{
+		FOOTSTEP_TRACE_FOOTSTEP(GetOwner(), SurfaceType_Default, Request.Category, false, INDEX_NONE, false);
+		return;
+	}
+
+	FFootstepRequest FootRequest = Request;
+	if (SoundSurfaces.Contains(PhysMat->SurfaceType))
+	{
+		FootRequest.bMuteSound = true;
+	}
+	else
+	{
+		SoundSurfaces.Add(PhysMat->SurfaceType);
+	}
+
+	GenerateFootstep(FootRequest, HitResult, PhysMat, bGenerateFX, Variation);
+}
+
+void UFootstepComponent::ResolveFootstep(const FFootstepRequest& Request)
+{
+	UWorld* World = GetWorld();
+	const AActor* Owner = GetOwner();
+
+	if (!(World && Owner)) { return; }
+
+	// The Pooling Manager doesn't exist on a Dedicated Server, so only events are generated there
+	UFootstepPoolingManager* PoolingManager = World->GetSubsystem<UFootstepPoolingManager>();
+	const UFootstepEventSubsystem* EventSubsystem = World->GetSubsystem<UFootstepEventSubsystem>();
+	const bool bGenerateEvents = EventSubsystem && EventSubsystem->ShouldGenerateEvents(this);
+
+	// Batched footsteps are culled together with their traces
+	if (FootstepScalability::GetBatch())
+	{
+		if (UFootstepBatchManager* BatchManager = World->GetSubsystem<UFootstepBatchManager>())
+		{
+			BatchManager->AddFootstep(this, Request, bGenerateEvents);
+			return;
+		}
+	}
+
+	const bool bGenerateFX = PoolingManager && PoolingManager->ShouldGenerateFootstep(Request.TraceStart);
+
+	if (!(bGenerateFX || bGenerateEvents)) { return; }
+
+	if (FootstepScalability::GetAsyncTrace())
+	{
+		FCollisionQueryParams QueryParams;
+		FCollisionObjectQueryParams ObjectParams;
+		MakeTraceParams(QueryParams, ObjectParams);
+
+		const FVector End = Request.TraceStart + (Request.TraceDirection.GetSafeNormal() * TraceLength);
+
+		FFootstepPendingTrace& PendingTrace = PendingTraces.AddDefaulted_GetRef();
+		PendingTrace.Request = Request;
+		PendingTrace.bGenerateFX = bGenerateFX;
+		PendingTrace.TraceHandle = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Request.TraceStart, End, ObjectParams, QueryParams, &AsyncTraceDelegate);
+
+		return;
+	}
+
+	FHitResult HitResult;
+	if (const UPhysicalMaterial* PhysMat = ResolveFootstepSurface(Request.TraceStart, Request.TraceDirection, HitResult))
+	{
+		GenerateFootstep(Request, HitResult, PhysMat, bGenerateFX);
+	}
+	else
+	{
+		FOOTSTEP_TRACE_FOOTSTEP(Owner, SurfaceType_Default, Request.Category, false, INDEX_NONE, false);
+	}
+}
+
+void UFootstepComponent::PrepareFootstep(const FFootstepRequest& Request)
+{
+	LLM_SCOPE_BYTAG(Footstep);
+
+	UWorld* World = GetWorld();
+
+	if (!(World && GetOwner() && FootstepSettings)) { return; }
+
+	// A newer prediction for the same foot replaces the previous one
+	PreparedTraces.RemoveAllSwap([&Request](const FFootstepPreparedTrace& PreparedTrace) {
+		return PreparedTrace.Request.SocketName == Request.SocketName;
 	});
 
-	const FCollisionObjectQueryParams ObjectParams = Invoke([this]()->FCollisionObjectQueryParams const {
-		FCollisionObjectQueryParams Params;
-		for (const ECollisionChannel ObjectType : FootstepSettings->GetFootstepObjectTypes())
+	FFootstepPreparedTrace& PreparedTrace = PreparedTraces.AddDefaulted_GetRef();
+	PreparedTrace.Request = Request;
+
+	// The budget is applied at the contact frame, only the distance is known to hold until then
+	const UFootstepPoolingManager* PoolingManager = World->GetSubsystem<UFootstepPoolingManager>();
+	const UFootstepEventSubsystem* EventSubsystem = World->GetSubsystem<UFootstepEventSubsystem>();
+	const bool bInCullDistance = PoolingManager && PoolingManager->IsInCullDistance(Request.TraceStart, FootstepScalability::GetCullDistance());
+	const bool bGenerateEvents = EventSubsystem && EventSubsystem->ShouldGenerateEvents(this);
+
+	if (!(bInCullDistance || bGenerateEvents)) { return; }
+
+	FCollisionQueryParams QueryParams;
+	FCollisionObjectQueryParams ObjectParams;
+	MakeTraceParams(QueryParams, ObjectParams);
+
+	const FVector End = Request.TraceStart + (Request.TraceDirection.GetSafeNormal() * TraceLength);
+
+	PreparedTrace.TraceHandle = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Request.TraceStart, End, ObjectParams, QueryParams, &PreparedTraceDelegate);
+}
+
+void UFootstepComponent::RequestPreparedFootstep(const FFootstepRequest& Request)
+{
+	LLM_SCOPE_BYTAG(Footstep);
+
+	UWorld* World = GetWorld();
+	const AActor* Owner = GetOwner();
+
+	if (!(World && Owner && FootstepSettings)) { return; }
+
+	const int32 PreparedIndex = PreparedTraces.IndexOfByPredicate([&Request](const FFootstepPreparedTrace& PreparedTrace) {
+		return PreparedTrace.Request.SocketName == Request.SocketName;
+	});
+
+	const FFootstepPreparedTrace* PreparedTrace = PreparedIndex != INDEX_NONE ? &PreparedTraces[PreparedIndex] : nullptr;
+	const UPhysicalMaterial* PhysMat = PreparedTrace && PreparedTrace->bResolved ? GetHitPhysicalMaterial(PreparedTrace->HitResult) : nullptr;
+
+	// Nothing to reuse, so the footstep is resolved at the contact frame
+	if (!PhysMat)
+	{
+		if (PreparedIndex != INDEX_NONE)
 		{
-			Params.AddObjectTypesToQuery(ObjectType);
+			PreparedTraces.RemoveAtSwap(PreparedIndex);
 		}
 
-		return Params;
+		RequestFootstep(Request);
+		return;
+	}
+
+	const FHitResult HitResult = PreparedTrace->HitResult;
+	const FFootstepVariation Variation = PreparedTrace->Variation;
+	PreparedTraces.RemoveAtSwap(PreparedIndex);
+
+	if (CoalesceFootstep(Request)) { return; }
+
+	// A delayed footstep is resolved again when it's released, like the other notifies of its burst
+	if (Request.bThrottled && DelayThrottledFootstep(Request)) { return; }
+
+	UFootstepPoolingManager* PoolingManager = World->GetSubsystem<UFootstepPoolingManager>();
+	const UFootstepEventSubsystem* EventSubsystem = World->GetSubsystem<UFootstepEventSubsystem>();
+	const bool bGenerateEvents = EventSubsystem && EventSubsystem->ShouldGenerateEvents(this);
+	const bool bGenerateFX = PoolingManager && PoolingManager->ShouldGenerateFootstep(HitResult.ImpactPoint);
+
+	if (!(bGenerateFX || bGenerateEvents)) { return; }
+
+	GenerateFootstep(Request, HitResult, PhysMat, bGenerateFX, &Variation);
+}
+
+void UFootstepComponent::CancelPreparedFootstep(FName SocketName)
+{
+	PreparedTraces.RemoveAllSwap([SocketName](const FFootstepPreparedTrace& PreparedTrace) {
+		return PreparedTrace.Request.SocketName == SocketName;
 	});
+}
+
+bool UFootstepComponent::CreateFootstepLineTrace(const FVector& Start, const FVector& DirectionNormalVector, FHitResult& OutHit) const
+{
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepTrace);
+
+	if (!GetWorld() && !FootstepSettings) { return false; }
+
+	UWorld* World = GetWorld();
+
+	const FVector DirVector = DirectionNormalVector.GetSafeNormal();
+	const FVector End = Start + (DirVector * TraceLength);
+
+	FCollisionQueryParams QueryParams;
+	FCollisionObjectQueryParams ObjectParams;
+	MakeTraceParams(QueryParams, ObjectParams);
 
 	const bool bTraceSuccessful = World->LineTraceSingleByObjectType(OutHit, Start, End, ObjectParams, QueryParams);
 
@@ -152,9 +420,26 @@ bool UFootstepComponent::CreateFootstepLineTrace(const FVector& Start, const FVe
 
 }
 
+const UPhysicalMaterial* UFootstepComponent::ResolveFootstepSurface(const FVector& Start, const FVector& DirectionNormalVector, FHitResult& OutHit) const
+{
+	const bool bTracePerformed = CreateFootstepLineTrace(Start, DirectionNormalVector, OutHit);
+
+	if (!(bTracePerformed && OutHit.bBlockingHit)) { return nullptr; }
+
+	return GetHitPhysicalMaterial(OutHit);
+}
+
 UFootstepDataAsset* UFootstepComponent::GetFootstepData(const EPhysicalSurface SurfaceType) const
 {
-	return FootstepFXes.Contains(SurfaceType) ? FootstepFXes[SurfaceType].LoadSynchronous() : nullptr;
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepSurfaceLookup);
+
+	const TSoftObjectPtr<UFootstepDataAsset>* DataAsset = FindFootstepData(SurfaceType);
+	return DataAsset ? FootstepAsset::LoadSynchronous(*DataAsset) : nullptr;
+}
+
+const TSoftObjectPtr<UFootstepDataAsset>* UFootstepComponent::FindFootstepData(const EPhysicalSurface SurfaceType) const
+{
+	return FootstepFXes.Find(SurfaceType);
 }
 
 float UFootstepComponent::GetTraceLength() const
@@ -171,6 +456,48 @@ bool UFootstepComponent::GetShowDebug() const
 #endif
 }
 
+void UFootstepComponent::LoadFootstepBundles(const TArray<FName>& Bundles)
+{
+	TArray<FPrimaryAssetId> AssetIds;
+	GetFootstepDataAssetIds(AssetIds);
+
+	if (AssetIds.IsEmpty()) { return; }
+
+	LLM_SCOPE_BYTAG(Footstep);
+
+	UAssetManager::Get().LoadPrimaryAssets(AssetIds, Bundles);
+}
+
+void UFootstepComponent::UnloadFootstepBundles()
+{
+	TArray<FPrimaryAssetId> AssetIds;
+	GetFootstepDataAssetIds(AssetIds);
+
+	if (AssetIds.IsEmpty()) { return; }
+
+	UAssetManager::Get().UnloadPrimaryAssets(AssetIds);
+}
+
+void UFootstepComponent::GetFootstepDataAssetIds(TArray<FPrimaryAssetId>& OutAssetIds) const
+{
+	if (!UAssetManager::IsInitialized()) { return; }
+
+	const UAssetManager& AssetManager = UAssetManager::Get();
+
+	for (const auto& It : FootstepFXes)
+	{
+		const FPrimaryAssetId AssetId = AssetManager.GetPrimaryAssetIdForPath(It.Value.ToSoftObjectPath());
+		if (AssetId.IsValid())
+		{
+			OutAssetIds.AddUnique(AssetId);
+		}
+		else if (!It.Value.IsNull())
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("%s isn't known to the Asset Manager, so its bundles can't be loaded. Check the Asset Manager section of the Surface Footstep System settings."), *It.Value.ToString());
+		}
+	}
+}
+
 void UFootstepComponent::TryPreloading()
 {
 	if ( !(bPreloadAssetsAsynchronously && !bPreloading) )
@@ -187,14 +514,22 @@ void UFootstepComponent::TryPreloading()
 
 	bPreloading = true;
 
+	LLM_SCOPE_BYTAG(Footstep);
+
 	FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
 	auto RequestAsyncLoad = [this, &StreamableManager](const EPhysicalSurface SurfaceType, const TSoftObjectPtr<UObject>& Asset)
 	{
 		if (Asset.IsPending())
 		{
-			StreamableManager.RequestAsyncLoad(Asset.ToSoftObjectPath(), FStreamableDelegate::CreateWeakLambda(this, [this, SurfaceType]()
+			FootstepAsset::OnAsyncLoadRequested();
+
+			// Not a weak lambda, so the Async Loads stat is decremented even if the component is gone
+			StreamableManager.RequestAsyncLoad(Asset.ToSoftObjectPath(), FStreamableDelegate::CreateLambda([WeakThis = TWeakObjectPtr<UFootstepComponent>(this), SurfaceType]()
 			{
-				if (UFootstepDataAsset* DataAsset = GetFootstepData(SurfaceType))
+				FootstepAsset::OnAsyncLoadCompleted();
+
+				const UFootstepComponent* This = WeakThis.Get();
+				if (UFootstepDataAsset* DataAsset = This ? This->GetFootstepData(SurfaceType) : nullptr)
 				{
 					DataAsset->RequestLoadingAssetsAsynchronously();
 				}
@@ -215,3 +550,471 @@ void UFootstepComponent::CancelPreloading()
 {
 	bPreloading = false;
 }
+
+void UFootstepComponent::MakeTraceParams(FCollisionQueryParams& OutQueryParams, FCollisionObjectQueryParams& OutObjectParams) const
+{
+	OutQueryParams.bReturnPhysicalMaterial = true;
+	OutQueryParams.bTraceComplex = FootstepSettings->GetTraceComplex();
+	OutQueryParams.AddIgnoredActor(GetOwner());
+	OutQueryParams.AddIgnoredActors(ActorsToIgnore);
+
+#if ENABLE_DRAW_DEBUG
+	if (bShowDebug)
+	{
+		const FName TraceTag = TEXT("Debug");
+		OutQueryParams.TraceTag = TraceTag;
+
+		GetWorld()->DebugDrawTraceTag = TraceTag;
+	}
+#endif
+
+	for (const ECollisionChannel ObjectType : FootstepSettings->GetFootstepObjectTypes())
+	{
+		OutObjectParams.AddObjectTypesToQuery(ObjectType);
+	}
+}
+
+void UFootstepComponent::OnAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepNotify);
+	LLM_SCOPE_BYTAG(Footstep);
+	FOOTSTEP_ALLOCATION_GUARD_SCOPE(TEXT("UFootstepComponent::OnAsyncTraceCompleted"));
+
+	const int32 PendingIndex = PendingTraces.IndexOfByPredicate([&TraceHandle](const FFootstepPendingTrace& PendingTrace) {
+		return PendingTrace.TraceHandle == TraceHandle;
+	});
+
+	if (PendingIndex == INDEX_NONE) { return; }
+
+	const FHitResult* HitResult = TraceDatum.OutHits.Num() > 0 ? &TraceDatum.OutHits[0] : nullptr;
+	const bool bBlockingHit = HitResult && HitResult->bBlockingHit;
+
+#if ENABLE_DRAW_DEBUG
+	if (bShowDebug)
+	{
+		DrawDebugLineTraceSingle(GetWorld(), TraceDatum.Start, TraceDatum.End, EDrawDebugTrace::Type::ForDuration, bBlockingHit, bBlockingHit ? *HitResult : FHitResult(), FLinearColor::Red, FLinearColor::Green, 2.f);
+	}
+#endif
+
+	// Merged feet wait for the rest of their group
+	if (PendingTraces[PendingIndex].MergeGroup != 0)
+	{
+		FFootstepPendingTrace& MergedTrace = PendingTraces[PendingIndex];
+		MergedTrace.bResolved = true;
+		if (bBlockingHit)
+		{
+			MergedTrace.HitResult = *HitResult;
+		}
+
+		CompleteMergeGroup(MergedTrace.MergeGroup);
+		return;
+	}
+
+	// Removed in order, so feet of a merge group stay in the order they have been requested in
+	const FFootstepPendingTrace PendingTrace = PendingTraces[PendingIndex];
+	PendingTraces.RemoveAt(PendingIndex);
+
+	if (!IsActive()) { return; }
+
+	const UPhysicalMaterial* PhysMat = bBlockingHit ? GetHitPhysicalMaterial(*HitResult) : nullptr;
+	if (PhysMat)
+	{
+		GenerateFootstep(PendingTrace.Request, *HitResult, PhysMat, PendingTrace.bGenerateFX);
+	}
+	else
+	{
+		FOOTSTEP_TRACE_FOOTSTEP(GetOwner(), SurfaceType_Default, PendingTrace.Request.Category, false, INDEX_NONE, false);
+	}
+}
+
+void UFootstepComponent::CompleteMergeGroup(uint32 MergeGroup)
+{
+	const bool bGroupPending = PendingTraces.ContainsByPredicate([MergeGroup](const FFootstepPendingTrace& PendingTrace) {
+		return PendingTrace.MergeGroup == MergeGroup && !PendingTrace.bResolved;
+	});
+
+	if (bGroupPending) { return; }
+
+	TArray<FFootstepPendingTrace, TInlineAllocator<4>> MergedTraces;
+	for (int32 Index = 0; Index < PendingTraces.Num();)
+	{
+		if (PendingTraces[Index].MergeGroup == MergeGroup)
+		{
+			MergedTraces.Add(MoveTemp(PendingTraces[Index]));
+			PendingTraces.RemoveAt(Index);
+		}
+		else
+		{
+			++Index;
+		}
+	}
+
+	if (!IsActive()) { return; }
+
+	TArray<EPhysicalSurface, TInlineAllocator<4>> SoundSurfaces;
+	for (const FFootstepPendingTrace& MergedTrace : MergedTraces)
+	{
+		const UPhysicalMaterial* PhysMat = MergedTrace.HitResult.bBlockingHit ? GetHitPhysicalMaterial(MergedTrace.HitResult) : nullptr;
+		GenerateMergedFootstep(MergedTrace.Request, MergedTrace.HitResult, PhysMat, MergedTrace.bGenerateFX, SoundSurfaces);
+	}
+}
+
+void UFootstepComponent::OnPreparedTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	LLM_SCOPE_BYTAG(Footstep);
+
+	FFootstepPreparedTrace* PreparedTrace = PreparedTraces.FindByPredicate([&TraceHandle](const FFootstepPreparedTrace& InPreparedTrace) {
+		return InPreparedTrace.TraceHandle == TraceHandle;
+	});
+
+	if (!PreparedTrace) { return; }
+
+	const FHitResult* HitResult = TraceDatum.OutHits.Num() > 0 ? &TraceDatum.OutHits[0] : nullptr;
+	const bool bBlockingHit = HitResult && HitResult->bBlockingHit;
+
+#if ENABLE_DRAW_DEBUG
+	if (bShowDebug)
+	{
+		DrawDebugLineTraceSingle(GetWorld(), TraceDatum.Start, TraceDatum.End, EDrawDebugTrace::Type::ForDuration, bBlockingHit, bBlockingHit ? *HitResult : FHitResult(), FLinearColor::Yellow, FLinearColor::Green, 2.f);
+	}
+#endif
+
+	PreparedTrace->bResolved = true;
+
+	const UPhysicalMaterial* PhysMat = bBlockingHit ? GetHitPhysicalMaterial(*HitResult) : nullptr;
+	if (!PhysMat) { return; }
+
+	PreparedTrace->HitResult = *HitResult;
+
+	// Load the Data Asset and the chosen assets now, so nothing is left to load at the contact frame
+	if (const UFootstepDataAsset* FootstepData = GetFootstepData(PhysMat->SurfaceType))
+	{
+		const FGameplayTag& FootstepCategory = PreparedTrace->Request.Category;
+		FRandomStream RandomStream(FMath::Rand());
+
+		PreparedTrace->Variation = FootstepData->SelectVariation(FootstepCategory, RandomStream);
+		FootstepData->GetSound(FootstepCategory, PreparedTrace->Variation.SoundIndex);
+
+		if (FootstepScalability::GetSpawnParticles())
+		{
+			FootstepData->GetParticle(FootstepCategory, PreparedTrace->Variation.ParticleIndex);
+		}
+	}
+}
+
+bool UFootstepComponent::CoalesceFootstep(const FFootstepRequest& Request)
+{
+	const float CoalescingWindow = FootstepSettings->GetCoalescingWindow();
+
+	// Requests without a socket can't be told apart, so different feet would be coalesced together
+	if (CoalescingWindow <= 0.f || Request.SocketName == NAME_None) { return false; }
+
+	// Late notifies of throttled meshes are compared at the time they should have happened
+	const double TimeSeconds = GetWorld()->GetTimeSeconds() - Request.Lateness;
+
+	FFootstepCoalescingWindow* Window = CoalescingWindows.FindByPredicate([&Request](const FFootstepCoalescingWindow& InWindow) {
+		return InWindow.SocketName == Request.SocketName;
+	});
+
+	if (Window && TimeSeconds - Window->StartTime < CoalescingWindow)
+	{
+		// Only a footstep which still waits for the window to close can be replaced
+		if (Request.Weight > Window->Weight)
+		{
+			const int32 PendingIndex = DelayedFootsteps.IndexOfByPredicate([&Request](const FFootstepDelayedRequest& DelayedFootstep) {
+				return DelayedFootstep.bCoalescing && DelayedFootstep.Request.SocketName == Request.SocketName;
+			});
+
+			if (PendingIndex != INDEX_NONE)
+			{
+				Window->Weight = Request.Weight;
+
+				// A fully weighted footstep can't be outweighed anymore, so it's released right away
+				if (Request.Weight >= 1.f)
+				{
+					DelayedFootsteps.RemoveAt(PendingIndex, EAllowShrinking::No);
+					return false;
+				}
+
+				DelayedFootsteps[PendingIndex].Request = Request;
+			}
+		}
+
+		return true;
+	}
+
+	if (!Window)
+	{
+		Window = &CoalescingWindows.AddDefaulted_GetRef();
+		Window->SocketName = Request.SocketName;
+	}
+
+	Window->StartTime = TimeSeconds;
+	Window->Weight = Request.Weight;
+
+	// A fully weighted footstep can't be outweighed, so it doesn't wait
+	if (Request.Weight >= 1.f) { return false; }
+
+	constexpr bool bCoalescing = true;
+	DelayFootstep(Request, FMath::Max(CoalescingWindow - Request.Lateness, 0.f), bCoalescing);
+
+	return true;
+}
+
+void UFootstepComponent::GenerateFootstep(const FFootstepRequest& Request, const FHitResult& HitResult, const UPhysicalMaterial* PhysMat, bool bGenerateFX, const FFootstepVariation* Variation)
+{
+	UWorld* World = GetWorld();
+	AActor* Owner = GetOwner();
+
+	if (!(World && Owner && PhysMat)) { return; }
+
+	const uint32 NumSyncLoads = FootstepAsset::GetNumSyncLoads();
+
+	// Get data from a Data Asset
+	const UFootstepDataAsset* FootstepData = GetFootstepData(PhysMat->SurfaceType);
+
+	if (!FootstepData) { return; }
+
+	INC_DWORD_STAT(STAT_FootstepCount);
+	CSV_CUSTOM_STAT(Footstep, Footsteps, 1, ECsvCustomStatOp::Accumulate);
+
+	UFootstepEventSubsystem* EventSubsystem = World->GetSubsystem<UFootstepEventSubsystem>();
+	if (EventSubsystem && Owner->HasAuthority())
+	{
+		EventSubsystem->AddNoiseEvent(Owner, HitResult.ImpactPoint, FootstepData->GetNoiseLoudness(), FootstepData->GetNoiseMaxRange());
+	}
+
+	// Only listeners of this component pay for creating native footstep events
+	FFootstepEvent FootstepEvent;
+	const bool bAddFootstepEvent = EventSubsystem && EventSubsystem->WantsFootstepEvents(this);
+	if (bAddFootstepEvent)
+	{
+		FootstepEvent.Owner = Owner;
+		FootstepEvent.Component = this;
+		FootstepEvent.Location = HitResult.ImpactPoint;
+		FootstepEvent.Normal = HitResult.ImpactNormal;
+		FootstepEvent.Category = Request.Category;
+		FootstepEvent.Time = World->GetTimeSeconds();
+		FootstepEvent.SurfaceType = PhysMat->SurfaceType;
+	}
+
+	// Event-only mode
+	UFootstepPoolingManager* PoolingManager = bGenerateFX ? World->GetSubsystem<UFootstepPoolingManager>() : nullptr;
+
+	if (!PoolingManager)
+	{
+		FOOTSTEP_TRACE_FOOTSTEP(Owner, PhysMat->SurfaceType, Request.Category, true, INDEX_NONE, FootstepAsset::GetNumSyncLoads() != NumSyncLoads);
+
+		if (bAddFootstepEvent)
+		{
+			FootstepEvent.Volume = Variation ? Variation->Volume : FootstepData->GetVolume();
+			FootstepEvent.Pitch = Variation ? Variation->Pitch : FootstepData->GetPitch();
+			EventSubsystem->AddFootstepEvent(FootstepEvent);
+		}
+		return;
+	}
+
+	const FGameplayTag& FootstepCategory = Request.Category;
+
+	if (GEngine && GetShowDebug())
+	{
+		FOOTSTEP_ALLOCATION_GUARD_SUSPEND();
+
+		const FString PhysMatName = PhysMat->GetName();
+		const FString DataAssetName = FootstepData->GetName();
+		const FString AnimationName = Request.Animation.IsValid() ? Request.Animation->GetName() : FString();
+		const FString CategoryName = FootstepCategory.ToString();
+		const FString SocketName = Request.SocketName != NAME_None ? Request.SocketName.ToString() : TEXT("ROOT");
+		const FString OwnerName = GetActorName(Owner);
+
+		const FString DebugMessage = TEXT("PhysMat: ") + PhysMatName + TEXT(", DataAsset: ") + DataAssetName + TEXT(", Anim: ") + AnimationName + TEXT(", Category: ") + CategoryName + TEXT(", Socket: ") + SocketName + TEXT(", Owner: ") + OwnerName + TEXT(", HitActor: ") + GetActorName(HitResult.GetActor()) + TEXT(", HitComp: ") + HitResult.GetComponent()->GetName();
+
+		GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Green, DebugMessage);
+		UE_LOG(LogFootstep, Log, TEXT("%s"), *DebugMessage);
+	}
+
+	FFootstepFXParams FXParams;
+	FXParams.Location = HitResult.ImpactPoint;
+	FXParams.Normal = HitResult.ImpactNormal;
+	FXParams.Forward = Owner->GetActorForwardVector();
+	FXParams.Variation = Variation;
+	FXParams.bWasRecentlyRendered = Owner->WasRecentlyRendered();
+	FXParams.bPlaySound2D = GetPlaySound2D();
+	FXParams.bDowngrade = Request.bThrottled && FootstepSettings->GetDowngradeThrottledFootsteps();
+	FXParams.bMuteSound = Request.bMuteSound;
+	FXParams.bHasVoice = !Request.bMuteSound && GetVoiceComponent() != nullptr;
+
+	// Every FX checks its own asset, so a footstep without any FX still reaches the events, the delegate, the trace and the recording
+	FFootstepFXResult FXResult;
+	PoolingManager->GenerateFootstepFX(*FootstepData, FootstepCategory, FXParams, FXResult);
+
+	if (FXResult.bUseVoice)
+	{
+		PlayFootstepVoice(PhysMat->SurfaceType, FootstepCategory, FXResult.Volume, FXResult.Pitch, FXParams.bPlaySound2D);
+	}
+
+	FOOTSTEP_TRACE_FOOTSTEP(Owner, PhysMat->SurfaceType, FootstepCategory, true, FXResult.PoolSlot, FootstepAsset::GetNumSyncLoads() != NumSyncLoads);
+	FOOTSTEP_RECORD_FOOTSTEP(*this, Request, HitResult, PhysMat->SurfaceType, FootstepData, FXResult.Sound, FXResult.Particle, FXResult.Volume, FXResult.Pitch, FXResult.ParticleScale, FXParams.bPlaySound2D);
+
+	if (bAddFootstepEvent)
+	{
+		FootstepEvent.Volume = FXResult.Volume;
+		FootstepEvent.Pitch = FXResult.Pitch;
+		EventSubsystem->AddFootstepEvent(FootstepEvent);
+	}
+
+	OnFootstepGenerated.Broadcast(PhysMat->SurfaceType, FootstepCategory, FXResult.Transform, FXResult.Volume, FXResult.Pitch, FXResult.SoundAssetVolume, FXResult.SoundAssetPitch, FXResult.ParticleScale);
+}
+
+bool UFootstepComponent::DelayThrottledFootstep(const FFootstepRequest& Request)
+{
+	if (!FootstepSettings->GetResequenceThrottledFootsteps()) { return false; }
+
+	// Notifies are fired in the timeline order, so the first one of a burst is the latest and is played right away
+	if (ThrottledBurstFrame != GFrameCounter)
+	{
+		ThrottledBurstFrame = GFrameCounter;
+		ThrottledBurstLateness = Request.Lateness;
+		return false;
+	}
+
+	const float Delay = ThrottledBurstLateness - Request.Lateness;
+
+	if (Delay <= UE_KINDA_SMALL_NUMBER) { return false; }
+
+	constexpr bool bCoalescing = false;
+	DelayFootstep(Request, Delay, bCoalescing);
+
+	return true;
+}
+
+void UFootstepComponent::DelayFootstep(const FFootstepRequest& Request, float Delay, bool bCoalescing)
+{
+	UWorld* World = GetWorld();
+	const double ReleaseTime = World->GetTimeSeconds() + Delay;
+
+	DelayedFootsteps.Add({ Request, ReleaseTime, bCoalescing });
+
+	// A zero delay still waits for the next frame, so later notifies of this frame can be coalesced
+	FTimerManager& TimerManager = World->GetTimerManager();
+	if (!TimerManager.IsTimerActive(DelayedFootstepsTimer) || TimerManager.GetTimerRemaining(DelayedFootstepsTimer) > Delay)
+	{
+		if (Delay > 0.f)
+		{
+			TimerManager.SetTimer(DelayedFootstepsTimer, this, &UFootstepComponent::ReleaseDelayedFootsteps, Delay, false);
+		}
+		else
+		{
+			DelayedFootstepsTimer = TimerManager.SetTimerForNextTick(this, &UFootstepComponent::ReleaseDelayedFootsteps);
+		}
+	}
+}
+
+void UFootstepComponent::ReleaseDelayedFootsteps()
+{
+	UWorld* World = GetWorld();
+
+	if (!World) { return; }
+
+	LLM_SCOPE_BYTAG(Footstep);
+
+	const double TimeSeconds = World->GetTimeSeconds();
+	double NextReleaseTime = TNumericLimits<double>::Max();
+
+	for (int32 i = 0; i < DelayedFootsteps.Num();)
+	{
+		if (DelayedFootsteps[i].ReleaseTime <= TimeSeconds + UE_KINDA_SMALL_NUMBER)
+		{
+			const FFootstepRequest Request = DelayedFootsteps[i].Request;
+			DelayedFootsteps.RemoveAt(i, EAllowShrinking::No);
+
+			ResolveFootstep(Request);
+		}
+		else
+		{
+			NextReleaseTime = FMath::Min(NextReleaseTime, DelayedFootsteps[i].ReleaseTime);
+			++i;
+		}
+	}
+
+	if (DelayedFootsteps.Num() > 0)
+	{
+		World->GetTimerManager().SetTimer(DelayedFootstepsTimer, this, &UFootstepComponent::ReleaseDelayedFootsteps, static_cast<float>(NextReleaseTime - TimeSeconds), false);
+	}
+}
+
+UAudioComponent* UFootstepComponent::GetVoiceComponent()
+{
+	if (VoiceComponent || FootstepVoice.IsNull()) { return VoiceComponent; }
+
+	AActor* Owner = GetOwner();
+	USoundBase* VoiceSound = FootstepAsset::LoadSynchronous(FootstepVoice);
+
+	if (!(Owner && VoiceSound)) { return nullptr; }
+
+	FOOTSTEP_ALLOCATION_GUARD_SUSPEND();
+
+	VoiceComponent = NewObject<UAudioComponent>(Owner, NAME_None, RF_Transient);
+	VoiceComponent->bAutoActivate = false;
+	VoiceComponent->bAutoDestroy = false;
+	VoiceComponent->SetSound(VoiceSound);
+	VoiceComponent->SetupAttachment(Owner->GetRootComponent());
+	VoiceComponent->RegisterComponent();
+
+	return VoiceComponent;
+}
+
+void UFootstepComponent::PlayFootstepVoice(EPhysicalSurface SurfaceType, const FGameplayTag& Category, float Volume, float Pitch, bool bPlaySound2D)
+{
+	if (!(VoiceComponent && FootstepSettings)) { return; }
+
+	if (VoiceComponent->bAllowSpatialization == bPlaySound2D)
+	{
+		// Spatialization is read when the sound starts, so the voice is restarted when it changes, for example after possession
+		VoiceComponent->bAllowSpatialization = !bPlaySound2D;
+		VoiceComponent->bIsUISound = bPlaySound2D;
+		VoiceComponent->Stop();
+	}
+
+	if (!VoiceComponent->IsPlaying())
+	{
+		VoiceComponent->Play();
+	}
+
+	const FFootstepVoiceParameters& VoiceParameters = FootstepSettings->GetVoiceParameters();
+
+	VoiceComponent->SetIntParameter(VoiceParameters.SurfaceType, SurfaceType);
+	VoiceComponent->SetIntParameter(VoiceParameters.Category, FootstepSettings->GetCategoryIndex(Category));
+	VoiceComponent->SetFloatParameter(VoiceParameters.Volume, Volume);
+	VoiceComponent->SetFloatParameter(VoiceParameters.Pitch, Pitch);
+	VoiceComponent->SetTriggerParameter(VoiceParameters.Trigger);
+}
+
+const UPhysicalMaterial* UFootstepComponent::GetHitPhysicalMaterial(const FHitResult& HitResult)
+{
+	if (HitResult.PhysMaterial.IsValid())
+	{
+		return HitResult.PhysMaterial.Get();
+	}
+	if (HitResult.Component.IsValid())
+	{
+		if (const FBodyInstance* BodyInstance = HitResult.GetComponent()->GetBodyInstance())
+		{
+			return BodyInstance->GetSimplePhysicalMaterial();
+		}
+	}
+
+	return nullptr;
+}
+
+FString UFootstepComponent::GetActorName(const AActor* Actor) const
+{
+	if (!Actor) { return FString(); }
+
+#if WITH_EDITOR
+	return Actor->GetActorLabel();
+#else
+	return Actor->GetName();
+#endif
+
+}
@@ -1,7 +1,9 @@
 // Copyright Urszula Kustra. All Rights Reserved.
 
 #include "FootstepDataAsset.h"
+#include "FootstepTypes.h"
 #include "NiagaraSystem.h"
+#include "NiagaraDataChannel.h"
 #include "SurfaceFootstepSystemSettings.h"
 #include "Engine/AssetManager.h"
 #include "UObject/ConstructorHelpers.h"
@@ -9,10 +11,26 @@
 #include "Sound/SoundAttenuation.h"
 #include "Sound/SoundConcurrency.h"
 #include "Logging/MessageLog.h"
+#if SFS_WITH_CASCADE
 #include "Particles/ParticleSystem.h"
+#endif
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
 
 #define LOCTEXT_NAMESPACE "FFootstepDataAsset"
 
+namespace FootstepDataAsset
+{
+	static int32 GetNumCascadeParticles(const FFootstepData& Data)
+	{
+#if SFS_WITH_CASCADE
+		return Data.Particles.Num();
+#else
+		return 0;
+#endif
+	}
+}
+
 UFootstepDataAsset::UFootstepDataAsset(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, MinVolume(1.f)
@@ -21,6 +39,9 @@ UFootstepDataAsset::UFootstepDataAsset(const FObjectInitializer& ObjectInitializ
 	, MaxPitch(1.f)
 	, MinParticleScale(1.0)
 	, MaxParticleScale(1.0)
+	, NoiseLoudness(1.f)
+	, NoiseMaxRange(0.f)
+	, FootprintLifeSpan(10.f)
 {
 	FootstepSettings = USurfaceFootstepSystemSettings::Get();
 
@@ -47,6 +68,65 @@ UFootstepDataAsset::UFootstepDataAsset(const FObjectInitializer& ObjectInitializ
 	}
 }
 
+const FPrimaryAssetType UFootstepDataAsset::PrimaryAssetType(TEXT("FootstepData"));
+
+FPrimaryAssetId UFootstepDataAsset::GetPrimaryAssetId() const
+{
+	return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
+
+#if WITH_EDITORONLY_DATA
+void UFootstepDataAsset::UpdateAssetBundleData()
+{
+	Super::UpdateAssetBundleData();
+
+	// Every category gets its own bundle, so game code can load, for instance, only walking and running footsteps
+	for (const auto& It : FootstepData)
+	{
+		const FFootstepData& Data = It.Value;
+		const FName BundleName = It.Key.GetTagName();
+
+		if (BundleName.IsNone()) { continue; }
+
+		TArray<FSoftObjectPath> AssetPaths;
+		auto AddAsset = [&AssetPaths](const TSoftObjectPtr<UObject>& Asset)
+		{
+			if (!Asset.IsNull())
+			{
+				AssetPaths.Add(Asset.ToSoftObjectPath());
+			}
+		};
+
+		for (const TSoftObjectPtr<USoundBase>& Sound : Data.Sounds)
+		{
+			AddAsset(Sound);
+		}
+
+#if SFS_WITH_CASCADE
+		for (const TSoftObjectPtr<UParticleSystem>& Particle : Data.Particles)
+		{
+			AddAsset(Particle);
+		}
+#endif
+
+		for (const TSoftObjectPtr<UNiagaraSystem>& Niagara : Data.NiagaraParticles)
+		{
+			AddAsset(Niagara);
+		}
+
+		AddAsset(Data.NiagaraDataChannel);
+		AddAsset(Data.NiagaraDataChannelSystem);
+		AddAsset(Data.FootprintMesh);
+		AddAsset(Data.FootprintMaterial);
+
+		if (AssetPaths.Num() > 0)
+		{
+			AssetBundleData.AddBundleAssetsTruncated(BundleName, AssetPaths);
+		}
+	}
+}
+#endif
+
 bool FFootstepData::AreSoundsValid() const
 {
 	for (const TSoftObjectPtr<USoundBase>& Sound : Sounds)
@@ -62,12 +142,15 @@ bool FFootstepData::AreSoundsValid() const
 
 void UFootstepDataAsset::RequestLoadingAssetsAsynchronously()
 {
+	LLM_SCOPE_BYTAG(Footstep);
+
 	FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
 	auto RequestAsyncLoad = [&StreamableManager](const TSoftObjectPtr<UObject>& Asset)
 	{
 		if (Asset.IsPending())
 		{
-			StreamableManager.RequestAsyncLoad(Asset.ToSoftObjectPath());
+			FootstepAsset::OnAsyncLoadRequested();
+			StreamableManager.RequestAsyncLoad(Asset.ToSoftObjectPath(), FStreamableDelegate::CreateStatic(&FootstepAsset::OnAsyncLoadCompleted));
 		}
 	};
 	
@@ -86,30 +169,84 @@ void UFootstepDataAsset::RequestLoadingAssetsAsynchronously()
 			RequestAsyncLoad(ConcurrencySettingsOverride);
 		}
 
+		RequestAsyncLoad(Data.FootprintMesh);
+		RequestAsyncLoad(Data.FootprintMaterial);
+
+		if (!Data.NiagaraDataChannel.IsNull())
+		{
+			RequestAsyncLoad(Data.NiagaraDataChannel);
+			RequestAsyncLoad(Data.NiagaraDataChannelSystem);
+			continue;
+		}
+
+#if SFS_WITH_CASCADE
 		for (const TSoftObjectPtr<UParticleSystem>& Particle : Data.Particles)
 		{
 			RequestAsyncLoad(Particle);
 		}
+#endif
 
 		for (const TSoftObjectPtr<UNiagaraSystem>& Niagara : Data.NiagaraParticles)
 		{
 			RequestAsyncLoad(Niagara);
 		}
 	}
+
+	for (const FFootstepLODTier& LODTier : LODTiers)
+	{
+		for (const TSoftObjectPtr<USoundBase>& Sound : LODTier.Sounds)
+		{
+			RequestAsyncLoad(Sound);
+		}
+
+		for (const TSoftObjectPtr<UNiagaraSystem>& Niagara : LODTier.NiagaraParticles)
+		{
+			RequestAsyncLoad(Niagara);
+		}
+	}
+}
+
+FFootstepVariation UFootstepDataAsset::SelectVariation(const FGameplayTag& CategoryTag, FRandomStream& RandomStream) const
+{
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepDataSelection);
+
+	FFootstepVariation Variation;
+	Variation.Volume = RandomStream.FRandRange(MinVolume, MaxVolume);
+	Variation.Pitch = RandomStream.FRandRange(MinPitch, MaxPitch);
+	Variation.ParticleScale = RandomStream.FRandRange(MinParticleScale, MaxParticleScale);
+
+	if (const FFootstepData* Data = FootstepData.Find(CategoryTag))
+	{
+		const int32 NumParticles = FootstepDataAsset::GetNumCascadeParticles(*Data) + Data->NiagaraParticles.Num();
+
+		Variation.SoundIndex = Data->Sounds.Num() > 0 ? RandomStream.RandHelper(Data->Sounds.Num()) : INDEX_NONE;
+		Variation.ParticleIndex = NumParticles > 0 ? RandomStream.RandHelper(NumParticles) : INDEX_NONE;
+	}
+
+	return Variation;
 }
 
 USoundBase* UFootstepDataAsset::GetSound(const FGameplayTag& CategoryTag) const
 {
+	const FFootstepData* Data = FootstepData.Find(CategoryTag);
+	const int32 NumSounds = Data ? Data->Sounds.Num() : 0;
+
+	return GetSound(CategoryTag, NumSounds > 0 ? FMath::RandHelper(NumSounds) : INDEX_NONE);
+}
+
+USoundBase* UFootstepDataAsset::GetSound(const FGameplayTag& CategoryTag, int32 SoundIndex) const
+{
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepDataSelection);
+
 	if (!FootstepSettings) { return nullptr; }
 
 	if (!FootstepSettings->ContainsCategory(CategoryTag))
 	{
 		PrintEditorError();
 	}
-	else if (FootstepData.Contains(CategoryTag))
+	else if (const FFootstepData* Data = FootstepData.Find(CategoryTag))
 	{
-		const TArray<TSoftObjectPtr<USoundBase>>& Sounds = FootstepData[CategoryTag].Sounds;
-		return Sounds.Num() > 0 ? Sounds[FMath::RandHelper(Sounds.Num())].LoadSynchronous() : nullptr;
+		return Data->Sounds.IsValidIndex(SoundIndex) ? FootstepAsset::LoadSynchronous(Data->Sounds[SoundIndex]) : nullptr;
 	}
 	else
 	{
@@ -131,29 +268,49 @@ float UFootstepDataAsset::GetPitch() const
 
 USoundAttenuation* UFootstepDataAsset::GetAttenuationOverride() const
 {
-	return AttenuationSettingsOverride.LoadSynchronous();
+	return FootstepAsset::LoadSynchronous(AttenuationSettingsOverride);
 }
 
 USoundConcurrency* UFootstepDataAsset::GetConcurrencyOverride() const
 {
-	return ConcurrencySettingsOverride.LoadSynchronous();
+	return FootstepAsset::LoadSynchronous(ConcurrencySettingsOverride);
 }
 
 UFXSystemAsset* UFootstepDataAsset::GetParticle(const FGameplayTag& CategoryTag) const
 {
+	const FFootstepData* Data = FootstepData.Find(CategoryTag);
+	const int32 NumParticles = Data ? FootstepDataAsset::GetNumCascadeParticles(*Data) + Data->NiagaraParticles.Num() : 0;
+
+	return GetParticle(CategoryTag, NumParticles > 0 ? FMath::RandHelper(NumParticles) : INDEX_NONE);
+}
+
+UFXSystemAsset* UFootstepDataAsset::GetParticle(const FGameplayTag& CategoryTag, int32 ParticleIndex) const
+{
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepDataSelection);
+
 	if (!FootstepSettings) { return nullptr; }
 
 	if (!FootstepSettings->ContainsCategory(CategoryTag))
 	{
 		PrintEditorError();
 	}
-	else if (FootstepData.Contains(CategoryTag))
+	else if (const FFootstepData* Data = FootstepData.Find(CategoryTag))
 	{
-		TArray<TSoftObjectPtr<UFXSystemAsset>> ActualParticles;
-		ActualParticles.Append(FootstepData[CategoryTag].Particles);
-		ActualParticles.Append(FootstepData[CategoryTag].NiagaraParticles);
+		if (!Data->NiagaraDataChannel.IsNull() || ParticleIndex == INDEX_NONE)
+		{
+			return nullptr;
+		}
+
+		// Picks from both arrays as if they were one, without copying them
+#if SFS_WITH_CASCADE
+		if (Data->Particles.IsValidIndex(ParticleIndex))
+		{
+			return FootstepAsset::LoadSynchronous(Data->Particles[ParticleIndex]);
+		}
+#endif
 
-		return ActualParticles.Num() > 0 ? ActualParticles[FMath::RandHelper(ActualParticles.Num())].LoadSynchronous() : nullptr;
+		const int32 NiagaraIndex = ParticleIndex - FootstepDataAsset::GetNumCascadeParticles(*Data);
+		return Data->NiagaraParticles.IsValidIndex(NiagaraIndex) ? FootstepAsset::LoadSynchronous(Data->NiagaraParticles[NiagaraIndex]) : nullptr;
 	}
 	else
 	{
@@ -163,6 +320,20 @@ UFXSystemAsset* UFootstepDataAsset::GetParticle(const FGameplayTag& CategoryTag)
 	return nullptr;
 }
 
+UNiagaraDataChannelAsset* UFootstepDataAsset::GetNiagaraDataChannel(const FGameplayTag& CategoryTag) const
+{
+	const FFootstepData* Data = FootstepData.Find(CategoryTag);
+
+	return Data ? FootstepAsset::LoadSynchronous(Data->NiagaraDataChannel) : nullptr;
+}
+
+UNiagaraSystem* UFootstepDataAsset::GetNiagaraDataChannelSystem(const FGameplayTag& CategoryTag) const
+{
+	const FFootstepData* Data = FootstepData.Find(CategoryTag);
+
+	return Data ? FootstepAsset::LoadSynchronous(Data->NiagaraDataChannelSystem) : nullptr;
+}
+
 FVector UFootstepDataAsset::GetRelScaleParticle() const
 {
 	const double RandScale = FMath::RandRange(MinParticleScale, MaxParticleScale);
@@ -170,11 +341,85 @@ FVector UFootstepDataAsset::GetRelScaleParticle() const
 	return FVector(RandScale);
 }
 
+UStaticMesh* UFootstepDataAsset::GetFootprintMesh(const FGameplayTag& CategoryTag) const
+{
+	const FFootstepData* Data = FootstepData.Find(CategoryTag);
+
+	return Data ? FootstepAsset::LoadSynchronous(Data->FootprintMesh) : nullptr;
+}
+
+UMaterialInterface* UFootstepDataAsset::GetFootprintMaterial(const FGameplayTag& CategoryTag) const
+{
+	const FFootstepData* Data = FootstepData.Find(CategoryTag);
+
+	return Data ? FootstepAsset::LoadSynchronous(Data->FootprintMaterial) : nullptr;
+}
+
+FVector UFootstepDataAsset::GetFootprintScale(const FGameplayTag& CategoryTag) const
+{
+	const FFootstepData* Data = FootstepData.Find(CategoryTag);
+
+	return Data ? Data->FootprintScale : FVector::OneVector;
+}
+
+float UFootstepDataAsset::GetFootprintLifeSpan() const
+{
+	return FootprintLifeSpan;
+}
+
 float UFootstepDataAsset::GetFootstepLifeSpan() const
 {
 	return FootstepLifeSpan;
 }
 
+const FFootstepLODTier* UFootstepDataAsset::FindLODTier(double ViewDistanceSquared) const
+{
+	const FFootstepLODTier* FoundTier = nullptr;
+
+	for (const FFootstepLODTier& LODTier : LODTiers)
+	{
+		if (FMath::Square(static_cast<double>(LODTier.MinDistance)) <= ViewDistanceSquared && (!FoundTier || LODTier.MinDistance > FoundTier->MinDistance))
+		{
+			FoundTier = &LODTier;
+		}
+	}
+
+	return FoundTier;
+}
+
+const FFootstepLODTier* UFootstepDataAsset::GetFarthestLODTier() const
+{
+	return FindLODTier(TNumericLimits<double>::Max());
+}
+
+USoundBase* UFootstepDataAsset::GetLODSound(const FFootstepLODTier& LODTier, int32 SoundIndex) const
+{
+	const int32 NumSounds = LODTier.Sounds.Num();
+	if (NumSounds == 0) { return nullptr; }
+
+	const int32 Index = SoundIndex != INDEX_NONE ? SoundIndex % NumSounds : FMath::RandHelper(NumSounds);
+	return FootstepAsset::LoadSynchronous(LODTier.Sounds[Index]);
+}
+
+UFXSystemAsset* UFootstepDataAsset::GetLODParticle(const FFootstepLODTier& LODTier, int32 ParticleIndex) const
+{
+	const int32 NumParticles = LODTier.NiagaraParticles.Num();
+	if (NumParticles == 0) { return nullptr; }
+
+	const int32 Index = ParticleIndex != INDEX_NONE ? ParticleIndex % NumParticles : FMath::RandHelper(NumParticles);
+	return FootstepAsset::LoadSynchronous(LODTier.NiagaraParticles[Index]);
+}
+
+float UFootstepDataAsset::GetNoiseLoudness() const
+{
+	return NoiseLoudness;
+}
+
+float UFootstepDataAsset::GetNoiseMaxRange() const
+{
+	return NoiseMaxRange;
+}
+
 void UFootstepDataAsset::PrintEditorError() const
 {
 	FMessageLog("PIE").Error( FText::Format(LOCTEXT("InvalidCategory", "{0} has a Footstep Category which is not set in the Surface Footstep System Settings in the Project Settings."), FText::FromString(GetName())) );
@@ -0,0 +1,204 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootstepEventSubsystem.h"
+#include "SurfaceFootstepSystemSettings.h"
+#include "FootstepTypes.h"
+#include "FootstepComponent.h"
+#include "Perception/AIPerceptionSystem.h"
+#include "Engine/World.h"
+
+UFootstepEventSubsystem::UFootstepEventSubsystem()
+	: Super()
+	, bNotifyingListeners(false)
+{
+}
+
+void UFootstepEventSubsystem::Deinitialize()
+{
+	PendingNoiseEvents.Empty();
+	PendingFootstepEvents.Empty();
+	ProcessingFootstepEvents.Empty();
+	FilteredFootstepEvents.Empty();
+	Listeners.Empty();
+	AddedListeners.Empty();
+
+	Super::Deinitialize();
+}
+
+void UFootstepEventSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	LLM_SCOPE_BYTAG(Footstep);
+	FlushNoiseEvents();
+	FlushFootstepEvents();
+}
+
+TStatId UFootstepEventSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFootstepEventSubsystem, STATGROUP_Tickables);
+}
+
+void UFootstepEventSubsystem::AddNoiseEvent(AActor* Instigator, const FVector& Location, float Loudness, float MaxRange)
+{
+	const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+	if (!(FootstepSettings && FootstepSettings->GetReportNoiseEvents() && Instigator && Loudness > 0.f)) { return; }
+
+	LLM_SCOPE_BYTAG(Footstep);
+
+	PendingNoiseEvents.Emplace(Instigator, Location, Loudness, MaxRange, FootstepSettings->GetNoiseEventTag());
+}
+
+void UFootstepEventSubsystem::AddFootstepEvent(const FFootstepEvent& FootstepEvent)
+{
+	LLM_SCOPE_BYTAG(Footstep);
+
+	PendingFootstepEvents.Add(FootstepEvent);
+}
+
+FDelegateHandle UFootstepEventSubsystem::AddFootstepEventsListener(FFootstepEventsDelegate&& Delegate, const AActor* OwnerFilter, const UFootstepComponent* ComponentFilter)
+{
+	if (!Delegate.IsBound()) { return FDelegateHandle(); }
+
+	const FDelegateHandle Handle = Delegate.GetHandle();
+
+	FFootstepEventsListener& Listener = bNotifyingListeners ? AddedListeners.AddDefaulted_GetRef() : Listeners.AddDefaulted_GetRef();
+	Listener.Delegate = MoveTemp(Delegate);
+	Listener.OwnerFilter = OwnerFilter;
+	Listener.ComponentFilter = ComponentFilter;
+	Listener.bFiltered = OwnerFilter || ComponentFilter;
+
+	return Handle;
+}
+
+void UFootstepEventSubsystem::RemoveFootstepEventsListener(FDelegateHandle Handle)
+{
+	AddedListeners.RemoveAll([Handle](const FFootstepEventsListener& Listener)
+	{
+		return Listener.Delegate.GetHandle() == Handle;
+	});
+
+	// The delegate may be executing, so it's only marked and removed after the loop
+	if (bNotifyingListeners)
+	{
+		for (FFootstepEventsListener& Listener : Listeners)
+		{
+			if (Listener.Delegate.GetHandle() == Handle)
+			{
+				Listener.bPendingRemove = true;
+			}
+		}
+		return;
+	}
+
+	Listeners.RemoveAll([Handle](const FFootstepEventsListener& Listener)
+	{
+		return Listener.Delegate.GetHandle() == Handle;
+	});
+}
+
+bool UFootstepEventSubsystem::ShouldGenerateEvents(const UFootstepComponent* Component) const
+{
+	const AActor* Owner = Component ? Component->GetOwner() : nullptr;
+	if (!Owner) { return false; }
+
+	const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+	if (FootstepSettings && FootstepSettings->GetReportNoiseEvents() && Owner->HasAuthority())
+	{
+		return true;
+	}
+
+	return WantsFootstepEvents(Component);
+}
+
+bool UFootstepEventSubsystem::WantsFootstepEvents(const UFootstepComponent* Component) const
+{
+	const AActor* Owner = Component ? Component->GetOwner() : nullptr;
+
+	for (const FFootstepEventsListener& Listener : Listeners)
+	{
+		if (!Listener.bPendingRemove && Listener.PassesFilter(Owner, Component))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UFootstepEventSubsystem::FFootstepEventsListener::PassesFilter(const AActor* Owner, const UFootstepComponent* Component) const
+{
+	if (!bFiltered) { return true; }
+
+	// A listener whose filter objects are gone doesn't receive anything
+	if (!OwnerFilter.IsExplicitlyNull() && OwnerFilter.Get() != Owner) { return false; }
+	if (!ComponentFilter.IsExplicitlyNull() && ComponentFilter.Get() != Component) { return false; }
+
+	return true;
+}
+
+void UFootstepEventSubsystem::FlushFootstepEvents()
+{
+	if (PendingFootstepEvents.Num() == 0) { return; }
+
+	// Footsteps generated by the listeners themselves are delivered in the next frame
+	Swap(PendingFootstepEvents, ProcessingFootstepEvents);
+	PendingFootstepEvents.Reset();
+
+	// Listeners can register and unregister while being notified, which is deferred until the end of the loop
+	bNotifyingListeners = true;
+
+	for (int32 i = 0; i < Listeners.Num(); ++i)
+	{
+		const FFootstepEventsListener& Listener = Listeners[i];
+
+		if (Listener.bPendingRemove || !Listener.Delegate.IsBound()) { continue; }
+
+		if (!Listener.bFiltered)
+		{
+			Listener.Delegate.Execute(ProcessingFootstepEvents);
+			continue;
+		}
+
+		FilteredFootstepEvents.Reset();
+		for (const FFootstepEvent& FootstepEvent : ProcessingFootstepEvents)
+		{
+			if (Listener.PassesFilter(FootstepEvent.Owner.Get(), FootstepEvent.Component.Get()))
+			{
+				FilteredFootstepEvents.Add(FootstepEvent);
+			}
+		}
+
+		if (FilteredFootstepEvents.Num() > 0)
+		{
+			Listener.Delegate.Execute(FilteredFootstepEvents);
+		}
+	}
+
+	bNotifyingListeners = false;
+
+	Listeners.RemoveAll([](const FFootstepEventsListener& Listener)
+	{
+		return Listener.bPendingRemove;
+	});
+
+	if (AddedListeners.Num() > 0)
+	{
+		Listeners.Append(MoveTemp(AddedListeners));
+		AddedListeners.Reset();
+	}
+
+	ProcessingFootstepEvents.Reset();
+}
+
+void UFootstepEventSubsystem::FlushNoiseEvents()
+{
+	if (PendingNoiseEvents.Num() == 0) { return; }
+
+	if (UAIPerceptionSystem* PerceptionSystem = UAIPerceptionSystem::GetCurrent(GetWorld()))
+	{
+		PerceptionSystem->OnEventsBatch(PendingNoiseEvents);
+	}
+
+	PendingNoiseEvents.Reset();
+}
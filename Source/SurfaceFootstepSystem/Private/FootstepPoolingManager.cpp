@@ -2,12 +2,56 @@
 
 #include "FootstepPoolingManager.h"
 #include "SurfaceFootstepSystemSettings.h"
+#include "FootstepScalability.h"
 #include "FootstepActor.h"
+#include "FootstepDataAsset.h"
+#include "FootprintManager.h"
+#include "FootstepTypes.h"
 #include "Engine.h"
 #include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "GameMapsSettings.h"
+#include "GameFramework/PlayerController.h"
+#include "NiagaraComponent.h"
+#include "NiagaraSystem.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraDataChannel.h"
+#include "NiagaraDataChannelAccessor.h"
+#include "AudioDevice.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundAttenuation.h"
+#include "Sound/SoundConcurrency.h"
+
+/** Whether the world is the seamless travel transition map, whose pool would be destroyed as soon as the destination is loaded. */
+static bool IsTransitionWorld(const UWorld& World)
+{
+	const FString& TransitionMap = UGameMapsSettings::GetGameMapsSettings()->TransitionMap.GetLongPackageName();
+	return !TransitionMap.IsEmpty() && UWorld::RemovePIEPrefix(World.GetOutermost()->GetName()) == TransitionMap;
+}
+
+/** Returns the pool snapshot of the world's game instance, so PIE instances and consecutive PIE sessions don't share it. */
+static TOptional<FFootstepPoolSnapshot>* GetPoolSnapshot(const UWorld& World)
+{
+	const UGameInstance* GameInstance = World.GetGameInstance();
+	UFootstepPoolSnapshotSubsystem* SnapshotSubsystem = GameInstance ? GameInstance->GetSubsystem<UFootstepPoolSnapshotSubsystem>() : nullptr;
+
+	return SnapshotSubsystem ? &SnapshotSubsystem->Snapshot : nullptr;
+}
 
 UFootstepPoolingManager::UFootstepPoolingManager()
 	: Super()
+	, CurrentWindowBucket(0)
+	, WindowBucketStartTime(0.0)
+	, PoolLimit(1)
+	, NumActiveActors(0)
+	, EvictionsSinceResize(0)
+	, LastEvictionTime(0.0)
+	, LastResizeTime(0.0)
+	, TotalEvictions(0)
+	, TotalSpawned(0)
+	, TotalTrimmed(0)
+	, TotalCulled(0)
+	, NumFootstepsThisFrame(0)
 {
 }
 
@@ -36,6 +80,35 @@ void UFootstepPoolingManager::DestroyFootstepPool(const UObject* WorldContextObj
 	}
 }
 
+void UFootstepPoolingManager::PrewarmFootstepPool(const UObject* WorldContextObject, int32 NumActors)
+{
+	if (!GEngine) { return; }
+
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull))
+	{
+		if (UFootstepPoolingManager* PoolingManager = World->GetSubsystem<UFootstepPoolingManager>())
+		{
+			PoolingManager->PrewarmPool(NumActors);
+		}
+	}
+}
+
+FFootstepPoolStats UFootstepPoolingManager::GetFootstepPoolStats(const UObject* WorldContextObject)
+{
+	if (GEngine)
+	{
+		if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull))
+		{
+			if (const UFootstepPoolingManager* PoolingManager = World->GetSubsystem<UFootstepPoolingManager>())
+			{
+				return PoolingManager->GetPoolStats();
+			}
+		}
+	}
+
+	return FFootstepPoolStats();
+}
+
 bool UFootstepPoolingManager::ShouldCreateSubsystem(UObject* Outer) const
 {
 	if (Super::ShouldCreateSubsystem(Outer))
@@ -49,39 +122,224 @@ bool UFootstepPoolingManager::ShouldCreateSubsystem(UObject* Outer) const
 	return false;
 }
 
+void UFootstepPoolingManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get())
+	{
+		PoolLimit = FootstepSettings->GetPoolSize();
+		ExpiryHeap.Reserve(FootstepSettings->GetPoolSizeCeiling());
+	}
+}
+
+void UFootstepPoolingManager::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+
+	if (!FootstepSettings || IsTransitionWorld(InWorld)) { return; }
+
+	int32 NumActors = FootstepSettings->GetPrewarmPoolSize();
+
+	// Start where the previous world has ended, including the limit the adaptive pool has grown to
+	if (TOptional<FFootstepPoolSnapshot>* Snapshot = GetPoolSnapshot(InWorld))
+	{
+		if (Snapshot->IsSet() && FootstepSettings->GetCarryPoolAcrossTravel())
+		{
+			if (FootstepSettings->GetAdaptivePoolSize())
+			{
+				PoolLimit = FMath::Clamp(Snapshot->GetValue().PoolLimit, FootstepSettings->GetPoolSize(), FootstepSettings->GetPoolSizeCeiling());
+			}
+
+			NumActors = FMath::Max(NumActors, Snapshot->GetValue().PoolSize);
+		}
+
+		Snapshot->Reset();
+	}
+
+	if (NumActors > 0)
+	{
+		PrewarmPool(NumActors);
+	}
+}
+
 void UFootstepPoolingManager::Deinitialize()
 {
-	DestroyFootstepPool(GetWorld());
+	const UWorld* World = GetWorld();
+	if (World && World->IsGameWorld() && World->HasBegunPlay() && !IsTransitionWorld(*World))
+	{
+		if (TOptional<FFootstepPoolSnapshot>* Snapshot = GetPoolSnapshot(*World))
+		{
+			RemoveInvalidActors();
+			*Snapshot = FFootstepPoolSnapshot{ PooledActors.Num(), PoolLimit };
+		}
+	}
+
+	DestroyFootstepPool(World);
+	DestroyDataChannelComponents();
 	
 	Super::Deinitialize();
 }
 
-bool UFootstepPoolingManager::SafeSpawnPooledActor()
+void UFootstepPoolingManager::Tick(float DeltaTime)
 {
-	if (const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get())
+	Super::Tick(DeltaTime);
+
+	LLM_SCOPE_BYTAG(Footstep);
+
+	const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+	const UWorld* World = GetWorld();
+
+	if (!(FootstepSettings && World)) { return; }
+
+	const double TimeSeconds = World->GetTimeSeconds();
+
+	ExpirePooledActors(TimeSeconds);
+	FlushDataChannels();
+	AdvanceWindow(TimeSeconds, FootstepSettings->GetAdaptivePoolWindow());
+	SamplePool();
+
+	if (FootstepSettings->GetAdaptivePoolSize())
 	{
-		RemoveInvalidActors();
-		
-		if (PooledActors.Num() < FootstepSettings->GetPoolSize())
-		{
-			const FActorSpawnParameters SpawnParams = Invoke([]()->FActorSpawnParameters const {
-				FActorSpawnParameters Params;
-				Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		UpdatePoolLimit(TimeSeconds, *FootstepSettings);
+	}
+	else
+	{
+		PoolLimit = FootstepSettings->GetPoolSize();
+		EvictionsSinceResize = 0;
+	}
 
-				return Params;
-			});
+	// Trimming or scalability could lower the limit
+	if (PooledActors.Num() > GetPoolLimit())
+	{
+		TrimIdleActors(GetPoolLimit());
+	}
 
-			const TObjectPtr<AFootstepActor> FootstepActor = GetWorld()->SpawnActor<AFootstepActor>(AFootstepActor::StaticClass(), FTransform(), SpawnParams);
+	UpdateViewLocations();
+	NumFootstepsThisFrame = 0;
 
-			PooledActors.Add(FootstepActor);
+	CSV_CUSTOM_STAT(Footstep, PoolSize, PooledActors.Num(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Footstep, PoolLimit, GetPoolLimit(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Footstep, ActiveActors, NumActiveActors, ECsvCustomStatOp::Set);
+}
 
-			return true;
-		}
+TStatId UFootstepPoolingManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFootstepPoolingManager, STATGROUP_Tickables);
+}
+
+bool UFootstepPoolingManager::ShouldGenerateFootstep(const FVector& Location)
+{
+	return ApplyFootstepBudget(IsInCullDistance(Location, FootstepScalability::GetCullDistance()));
+}
+
+bool UFootstepPoolingManager::IsInCullDistance(const FVector& Location, float CullDistance) const
+{
+	if (CullDistance > 0.f && ViewLocations.Num() > 0)
+	{
+		const double CullDistanceSq = FMath::Square(CullDistance);
+		return ViewLocations.ContainsByPredicate([&Location, CullDistanceSq](const FVector& ViewLocation) {
+			return FVector::DistSquared(ViewLocation, Location) <= CullDistanceSq;
+		});
+	}
+
+	return true;
+}
+
+double UFootstepPoolingManager::GetViewDistanceSquared(const FVector& Location) const
+{
+	if (ViewLocations.Num() == 0) { return 0.0; }
+
+	double MinDistanceSq = TNumericLimits<double>::Max();
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		MinDistanceSq = FMath::Min(MinDistanceSq, FVector::DistSquared(ViewLocation, Location));
+	}
+
+	return MinDistanceSq;
+}
+
+bool UFootstepPoolingManager::ApplyFootstepBudget(bool bInCullDistance)
+{
+	if (!bInCullDistance)
+	{
+		++TotalCulled;
+		INC_DWORD_STAT(STAT_FootstepCulled);
+		CSV_CUSTOM_STAT(Footstep, Culled, 1, ECsvCustomStatOp::Accumulate);
+		return false;
+	}
+
+	const int32 MaxFootstepsPerFrame = FootstepScalability::GetMaxFootstepsPerFrame();
+	if (MaxFootstepsPerFrame != INDEX_NONE && NumFootstepsThisFrame >= MaxFootstepsPerFrame)
+	{
+		++TotalCulled;
+		INC_DWORD_STAT(STAT_FootstepCulled);
+		CSV_CUSTOM_STAT(Footstep, Culled, 1, ECsvCustomStatOp::Accumulate);
+		return false;
+	}
+
+	++NumFootstepsThisFrame;
+	return true;
+}
+
+bool UFootstepPoolingManager::SafeSpawnPooledActor()
+{
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepPoolAcquire);
+
+	RemoveInvalidActors();
+	
+	if (PooledActors.Num() < GetPoolLimit())
+	{
+		// Pool growth isn't a part of the steady state
+		FOOTSTEP_ALLOCATION_GUARD_SUSPEND();
+
+		SpawnPooledActor();
+		return true;
 	}
 
 	return false;
 }
 
+int32 UFootstepPoolingManager::PrewarmPool(int32 NumActors)
+{
+	FOOTSTEP_ALLOCATION_GUARD_SUSPEND();
+
+	RemoveInvalidActors();
+
+	const int32 TargetSize = FMath::Min(PooledActors.Num() + FMath::Max(NumActors, 0), GetPoolLimit());
+	const int32 NumSpawned = FMath::Max(TargetSize - PooledActors.Num(), 0);
+
+	PooledActors.Reserve(TargetSize);
+
+	for (int32 i = 0; i < NumSpawned; ++i)
+	{
+		SpawnPooledActor();
+	}
+
+	return NumSpawned;
+}
+
+AFootstepActor* UFootstepPoolingManager::SpawnPooledActor()
+{
+	LLM_SCOPE_BYTAG(Footstep);
+
+	const FActorSpawnParameters SpawnParams = Invoke([]()->FActorSpawnParameters const {
+		FActorSpawnParameters Params;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		return Params;
+	});
+
+	const TObjectPtr<AFootstepActor> FootstepActor = GetWorld()->SpawnActor<AFootstepActor>(AFootstepActor::StaticClass(), FTransform(), SpawnParams);
+
+	PooledActors.Add(FootstepActor);
+	++TotalSpawned;
+
+	return FootstepActor;
+}
+
 void UFootstepPoolingManager::DestroyPooledActors()
 {
 	for (const TObjectPtr<AFootstepActor>& Actor : PooledActors)
@@ -93,14 +351,21 @@ void UFootstepPoolingManager::DestroyPooledActors()
 	}
 
 	PooledActors.Reset();
+	ExpiryHeap.Reset();
+	NumActiveActors = 0;
 }
 
 AFootstepActor* UFootstepPoolingManager::GetPooledActor(bool bRemoveInvalidActors)
 {
+	FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepPoolAcquire);
+
 	if (bRemoveInvalidActors)
 	{
 		RemoveInvalidActors();
 	}
+
+	FFootstepPoolWindowBucket& Bucket = WindowBuckets[CurrentWindowBucket];
+	++Bucket.Acquisitions;
 	
 	for (const TObjectPtr<AFootstepActor>& Actor : PooledActors)
 	{
@@ -118,9 +383,458 @@ AFootstepActor* UFootstepPoolingManager::GetPooledActor(bool bRemoveInvalidActor
 			PooledActors.Add(PooledActor);
 			PooledActors.RemoveAt(0);
 
+			++Bucket.Evictions;
+			++EvictionsSinceResize;
+			++TotalEvictions;
+			INC_DWORD_STAT(STAT_FootstepEvictions);
+			CSV_CUSTOM_STAT(Footstep, Evictions, 1, ECsvCustomStatOp::Accumulate);
+			LastEvictionTime = GetWorld()->GetTimeSeconds();
+
 			return PooledActor.Get();
 		}
 	}
 
 	return nullptr;
 }
+
+int32 UFootstepPoolingManager::GetPooledActorIndex(const AFootstepActor* Actor) const
+{
+	return PooledActors.IndexOfByKey(Actor);
+}
+
+void UFootstepPoolingManager::ActivatePooledActor(AFootstepActor* Actor, float LifeSpan)
+{
+	if (!IsValid(Actor)) { return; }
+
+	Actor->SetPoolingActive(true);
+
+	if (Actor->IsPoolingActive() && LifeSpan > 0.f)
+	{
+		FFootstepExpiry Expiry;
+		Expiry.Deadline = GetWorld()->GetTimeSeconds() + LifeSpan;
+		Expiry.Actor = Actor;
+		Expiry.PoolingSerial = Actor->GetPoolingSerial();
+
+		ExpiryHeap.HeapPush(MoveTemp(Expiry));
+	}
+}
+
+bool UFootstepPoolingManager::CanPlayFootstepSound(USoundBase* Sound, const FVector& Location, bool bIs2D, USoundAttenuation* AttenuationOverride, USoundConcurrency* ConcurrencyOverride) const
+{
+	if (!Sound) { return false; }
+
+	const FAudioDevice* AudioDevice = GetWorld()->GetAudioDeviceRaw();
+	if (!AudioDevice) { return false; }
+
+	float DistanceSq = 0.f;
+
+	if (!bIs2D)
+	{
+		const float MaxDistance = Invoke([Sound, AttenuationOverride]()->float {
+			if (AttenuationOverride)
+			{
+				return AttenuationOverride->Attenuation.bAttenuate ? AttenuationOverride->Attenuation.GetMaxDimension() : FAudioDevice::GetMaxWorldDistance();
+			}
+
+			return Sound->GetMaxDistance();
+		});
+
+		if (!AudioDevice->LocationIsAudible(Location, MaxDistance))
+		{
+			return false;
+		}
+
+		AudioDevice->GetDistanceSquaredToNearestListener(Location, DistanceSq);
+	}
+
+	if (!ConcurrencyOverride) { return true; }
+
+	// Only rules which cull the new sound can be evaluated up front. Owner-limited groups never fill up, because every Footstep Actor is a separate owner
+	const FSoundConcurrencySettings& Concurrency = ConcurrencyOverride->Concurrency;
+	const bool bPreventNew = Concurrency.ResolutionRule == EMaxConcurrentResolutionRule::PreventNew;
+	const bool bStopFarthestThenPreventNew = Concurrency.ResolutionRule == EMaxConcurrentResolutionRule::StopFarthestThenPreventNew;
+
+	if (Concurrency.bLimitToOwner || !(bPreventNew || bStopFarthestThenPreventNew))
+	{
+		return true;
+	}
+
+	int32 NumPlaying = 0;
+	float FarthestDistanceSq = 0.f;
+
+	for (const TObjectPtr<AFootstepActor>& Actor : PooledActors)
+	{
+		if (IsValid(Actor) && Actor->IsPlayingSound(ConcurrencyOverride))
+		{
+			++NumPlaying;
+
+			float ActorDistanceSq = 0.f;
+			if (bStopFarthestThenPreventNew && AudioDevice->GetDistanceSquaredToNearestListener(Actor->GetActorLocation(), ActorDistanceSq))
+			{
+				FarthestDistanceSq = FMath::Max(FarthestDistanceSq, ActorDistanceSq);
+			}
+		}
+	}
+
+	if (NumPlaying < Concurrency.GetMaxCount())
+	{
+		return true;
+	}
+
+	return bStopFarthestThenPreventNew && DistanceSq < FarthestDistanceSq;
+}
+
+void UFootstepPoolingManager::AddDataChannelFootstep(UNiagaraDataChannelAsset* DataChannel, UNiagaraSystem* DataChannelSystem, const FVector& Position, const FVector& Normal, float Scale)
+{
+	if (!DataChannel) { return; }
+
+	LLM_SCOPE_BYTAG(Footstep);
+
+	if (DataChannelSystem && !DataChannelComponents.Contains(DataChannelSystem))
+	{
+		constexpr bool bAutoDestroy = false;
+		constexpr bool bAutoActivate = true;
+		constexpr bool bPreCullCheck = false;
+		UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), DataChannelSystem, FVector::ZeroVector, FRotator::ZeroRotator, FVector::OneVector, bAutoDestroy, bAutoActivate, ENCPoolMethod::None, bPreCullCheck);
+
+		DataChannelComponents.Add(DataChannelSystem, NiagaraComponent);
+	}
+
+	int32 ChannelIndex = INDEX_NONE;
+	if (const int32* FoundIndex = DataChannelIndices.Find(DataChannel))
+	{
+		ChannelIndex = *FoundIndex;
+	}
+	else
+	{
+		ChannelIndex = PendingDataChannelEntries.AddDefaulted();
+		DataChannelIndices.Add(DataChannel, ChannelIndex);
+	}
+
+	PendingDataChannelEntries[ChannelIndex].Add({ Position, Normal, Scale });
+}
+
+bool UFootstepPoolingManager::GenerateFootstepFX(const UFootstepDataAsset& FootstepData, const FGameplayTag& Category, const FFootstepFXParams& Params, FFootstepFXResult& OutResult)
+{
+	UWorld* World = GetWorld();
+
+	if (!World) { return false; }
+
+	const FFootstepVariation* Variation = Params.Variation;
+
+	// Distant and off-screen footsteps use a cheaper tier, chosen before anything is taken from the pool. Downgraded footsteps use the cheapest one.
+	const FFootstepLODTier* LODTier = Params.bDowngrade ? FootstepData.GetFarthestLODTier() : FootstepData.FindLODTier(GetViewDistanceSquared(Params.Location));
+	const bool bDropSound = LODTier && LODTier->bDropSound;
+	const bool bDropParticles = (Params.bDowngrade && !LODTier) || (LODTier && (LODTier->bDropParticles || (LODTier->bDropParticlesWhenNotRendered && !Params.bWasRecentlyRendered)));
+
+	// A Footstep Voice replaces the sound of the Footstep Actor
+	const bool bMuteSound = bDropSound || Params.bMuteSound;
+	OutResult.bUseVoice = !bMuteSound && Params.bHasVoice;
+
+	USoundBase* FootstepSound = nullptr;
+	if (!(bMuteSound || OutResult.bUseVoice))
+	{
+		const int32 SoundIndex = Variation ? Variation->SoundIndex : INDEX_NONE;
+
+		if (LODTier && LODTier->Sounds.Num() > 0)
+		{
+			FootstepSound = FootstepData.GetLODSound(*LODTier, SoundIndex);
+		}
+		else
+		{
+			FootstepSound = Variation ? FootstepData.GetSound(Category, SoundIndex) : FootstepData.GetSound(Category);
+		}
+	}
+	USoundAttenuation* AttenuationOverride = FootstepSound ? FootstepData.GetAttenuationOverride() : nullptr;
+	USoundConcurrency* ConcurrencyOverride = FootstepSound ? FootstepData.GetConcurrencyOverride() : nullptr;
+
+	// Events and delegates describe the footstep itself, not whether the local listener can hear it
+	const bool bHasSound = FootstepSound || OutResult.bUseVoice;
+	OutResult.SoundAssetVolume = FootstepSound ? FootstepSound->GetVolumeMultiplier() : 0.f;
+	OutResult.SoundAssetPitch = FootstepSound ? FootstepSound->GetPitchMultiplier() : 0.f;
+
+	// Skip the audio side if the sound would be out of range or culled by its concurrency group right away
+	if (FootstepSound && !CanPlayFootstepSound(FootstepSound, Params.Location, Params.bPlaySound2D, AttenuationOverride, ConcurrencyOverride))
+	{
+		FootstepSound = nullptr;
+	}
+
+	const bool bSpawnParticles = !bDropParticles && FootstepScalability::GetSpawnParticles();
+	UFXSystemAsset* FootstepParticle = nullptr;
+	if (bSpawnParticles)
+	{
+		const int32 ParticleIndex = Variation ? Variation->ParticleIndex : INDEX_NONE;
+
+		if (LODTier && LODTier->NiagaraParticles.Num() > 0)
+		{
+			FootstepParticle = FootstepData.GetLODParticle(*LODTier, ParticleIndex);
+		}
+		else
+		{
+			FootstepParticle = Variation ? FootstepData.GetParticle(Category, ParticleIndex) : FootstepData.GetParticle(Category);
+		}
+	}
+
+	UNiagaraDataChannelAsset* FootstepDataChannel = bSpawnParticles ? FootstepData.GetNiagaraDataChannel(Category) : nullptr;
+	const bool bSpawnParticle = FootstepParticle || FootstepDataChannel;
+	UStaticMesh* FootprintMesh = FootstepData.GetFootprintMesh(Category);
+
+	const FQuat ActorQuat = bSpawnParticle ? FRotationMatrix::MakeFromZ(Params.Normal).ToQuat() : FQuat(EForceInit::ForceInitToZero);
+	OutResult.Transform = FTransform(ActorQuat, Params.Location, FVector::OneVector);
+	OutResult.ParticleScale = bSpawnParticle ? (Variation ? FVector(Variation->ParticleScale) : FootstepData.GetRelScaleParticle()) : FVector::ZeroVector;
+	OutResult.Volume = bHasSound ? (Variation ? Variation->Volume : FootstepData.GetVolume()) : 0.f;
+	OutResult.Pitch = bHasSound ? (Variation ? Variation->Pitch : FootstepData.GetPitch()) : 0.f;
+
+	// Particles from a Niagara Data Channel are written in one batch per frame
+	if (FootstepDataChannel)
+	{
+		AddDataChannelFootstep(FootstepDataChannel, FootstepData.GetNiagaraDataChannelSystem(Category), Params.Location, Params.Normal, OutResult.ParticleScale.X);
+	}
+
+	// Footprints are instances in a ring buffer, shared by all footprints with the same mesh and material
+	if (FootprintMesh)
+	{
+		if (UFootprintManager* FootprintManager = World->GetSubsystem<UFootprintManager>())
+		{
+			const FQuat FootprintQuat = FRotationMatrix::MakeFromZX(Params.Normal, Params.Forward).ToQuat();
+			const FTransform FootprintTransform = FTransform(FootprintQuat, Params.Location, FootstepData.GetFootprintScale(Category));
+
+			FootprintManager->AddFootprint(FootprintMesh, FootstepData.GetFootprintMaterial(Category), FootprintTransform, FootstepData.GetFootprintLifeSpan());
+		}
+	}
+
+	// Finally, activate a footstep actor
+	if (FootstepSound || FootstepParticle)
+	{
+		SafeSpawnPooledActor();
+
+		constexpr bool bRemoveInvalidActors = false;
+		if (AFootstepActor* FootstepActor = GetPooledActor(bRemoveInvalidActors))
+		{
+			FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepActorInit);
+
+			FootstepActor->SetPoolingActive(false);
+			FootstepActor->SetActorTransform(OutResult.Transform);
+
+			FootstepActor->InitSound(FootstepSound, OutResult.Volume, OutResult.Pitch, Params.bPlaySound2D, AttenuationOverride, ConcurrencyOverride);
+			FootstepActor->InitParticle(FootstepParticle, OutResult.ParticleScale);
+
+			ActivatePooledActor(FootstepActor, FootstepData.GetFootstepLifeSpan());
+
+			if (FOOTSTEP_TRACE_IS_ENABLED())
+			{
+				OutResult.PoolSlot = GetPooledActorIndex(FootstepActor);
+			}
+		}
+	}
+
+	OutResult.Sound = FootstepSound;
+	OutResult.Particle = FootstepParticle;
+
+	return bHasSound || bSpawnParticle || FootprintMesh;
+}
+
+int32 UFootstepPoolingManager::GetPoolLimit() const
+{
+	const int32 MaxPoolSize = FootstepScalability::GetMaxPoolSize();
+	return MaxPoolSize != INDEX_NONE ? FMath::Min(PoolLimit, MaxPoolSize) : PoolLimit;
+}
+
+FFootstepPoolStats UFootstepPoolingManager::GetPoolStats() const
+{
+	FFootstepPoolStats Stats;
+	Stats.PoolSize = PooledActors.Num();
+	Stats.PoolLimit = GetPoolLimit();
+	Stats.ActiveActors = NumActiveActors;
+	Stats.TotalEvictions = TotalEvictions;
+	Stats.TotalSpawned = TotalSpawned;
+	Stats.TotalTrimmed = TotalTrimmed;
+	Stats.TotalCulled = TotalCulled;
+
+	int32 MinIdleSlots = MAX_int32;
+	for (const FFootstepPoolWindowBucket& Bucket : WindowBuckets)
+	{
+		Stats.HighWaterMark = FMath::Max(Stats.HighWaterMark, Bucket.HighWaterMark);
+		Stats.Acquisitions += Bucket.Acquisitions;
+		Stats.Evictions += Bucket.Evictions;
+		MinIdleSlots = FMath::Min(MinIdleSlots, Bucket.MinIdleSlots);
+	}
+	Stats.IdleSlots = MinIdleSlots != MAX_int32 ? MinIdleSlots : 0;
+
+	if (const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get())
+	{
+		Stats.EvictionRate = Stats.Evictions / FootstepSettings->GetAdaptivePoolWindow();
+	}
+
+	return Stats;
+}
+
+void UFootstepPoolingManager::ExpirePooledActors(double TimeSeconds)
+{
+	FFootstepExpiry Expiry;
+	while (ExpiryHeap.Num() > 0 && ExpiryHeap.HeapTop().Deadline <= TimeSeconds)
+	{
+		ExpiryHeap.HeapPop(Expiry, EAllowShrinking::No);
+
+		// The actor could be reused after this entry was scheduled
+		AFootstepActor* Actor = Expiry.Actor.Get();
+		if (IsValid(Actor) && Actor->GetPoolingSerial() == Expiry.PoolingSerial)
+		{
+			Actor->SetPoolingActive(false);
+		}
+	}
+}
+
+void UFootstepPoolingManager::FlushDataChannels()
+{
+	static const FName PositionName = TEXT("Position");
+	static const FName NormalName = TEXT("Normal");
+	static const FName ScaleName = TEXT("Scale");
+
+	for (const auto& It : DataChannelIndices)
+	{
+		TArray<FFootstepDataChannelEntry>& Entries = PendingDataChannelEntries[It.Value];
+		if (Entries.Num() == 0 || !It.Key)
+		{
+			Entries.Reset();
+			continue;
+		}
+
+		// One write for all footsteps from this frame
+		constexpr bool bVisibleToGame = false;
+		constexpr bool bVisibleToCPU = true;
+		constexpr bool bVisibleToGPU = true;
+		if (UNiagaraDataChannelWriter* Writer = UNiagaraDataChannelLibrary::WriteToNiagaraDataChannel(GetWorld(), It.Key, FNiagaraDataChannelSearchParameters(), Entries.Num(), bVisibleToGame, bVisibleToCPU, bVisibleToGPU, GetName()))
+		{
+			for (int32 i = 0; i < Entries.Num(); ++i)
+			{
+				Writer->WritePosition(PositionName, i, Entries[i].Position);
+				Writer->WriteVector(NormalName, i, Entries[i].Normal);
+				Writer->WriteFloat(ScaleName, i, Entries[i].Scale);
+			}
+		}
+
+		Entries.Reset();
+	}
+}
+
+void UFootstepPoolingManager::DestroyDataChannelComponents()
+{
+	for (const auto& It : DataChannelComponents)
+	{
+		if (IsValid(It.Value))
+		{
+			It.Value->DestroyComponent();
+		}
+	}
+
+	DataChannelComponents.Reset();
+	DataChannelIndices.Reset();
+	PendingDataChannelEntries.Reset();
+}
+
+void UFootstepPoolingManager::SamplePool()
+{
+	NumActiveActors = 0;
+	for (const TObjectPtr<AFootstepActor>& Actor : PooledActors)
+	{
+		if (IsValid(Actor) && Actor->IsPoolingActive())
+		{
+			++NumActiveActors;
+		}
+	}
+
+	FFootstepPoolWindowBucket& Bucket = WindowBuckets[CurrentWindowBucket];
+	Bucket.HighWaterMark = FMath::Max(Bucket.HighWaterMark, NumActiveActors);
+	Bucket.MinIdleSlots = FMath::Min(Bucket.MinIdleSlots, PooledActors.Num() - NumActiveActors);
+}
+
+void UFootstepPoolingManager::UpdateViewLocations()
+{
+	ViewLocations.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+}
+
+void UFootstepPoolingManager::AdvanceWindow(double TimeSeconds, float WindowLength)
+{
+	const double BucketLength = WindowLength / NumWindowBuckets;
+
+	// Skip at most a whole window, older buckets would be reset anyway
+	for (int32 i = 0; i < NumWindowBuckets && TimeSeconds - WindowBucketStartTime >= BucketLength; ++i)
+	{
+		CurrentWindowBucket = (CurrentWindowBucket + 1) % NumWindowBuckets;
+		WindowBuckets[CurrentWindowBucket] = FFootstepPoolWindowBucket();
+		WindowBucketStartTime += BucketLength;
+	}
+
+	if (TimeSeconds - WindowBucketStartTime >= BucketLength)
+	{
+		WindowBucketStartTime = TimeSeconds;
+	}
+}
+
+void UFootstepPoolingManager::UpdatePoolLimit(double TimeSeconds, const USurfaceFootstepSystemSettings& FootstepSettings)
+{
+	const int32 MinPoolLimit = FootstepSettings.GetPoolSize();
+	const int32 MaxPoolLimit = FootstepSettings.GetPoolSizeCeiling();
+
+	// Grow by the amount of footsteps which had to evict an active Footstep Actor
+	if (EvictionsSinceResize > 0)
+	{
+		PoolLimit = FMath::Clamp(PoolLimit + EvictionsSinceResize, MinPoolLimit, MaxPoolLimit);
+		EvictionsSinceResize = 0;
+		LastResizeTime = TimeSeconds;
+
+		return;
+	}
+
+	const float TrimCooldown = FootstepSettings.GetAdaptivePoolTrimCooldown();
+	if (TimeSeconds - LastEvictionTime < TrimCooldown || TimeSeconds - LastResizeTime < TrimCooldown)
+	{
+		PoolLimit = FMath::Clamp(PoolLimit, MinPoolLimit, MaxPoolLimit);
+		return;
+	}
+
+	// Trim slots which stayed idle during the whole window. Idle slots are counted among spawned actors, so the new limit is based on the pool size.
+	int32 MinIdleSlots = MAX_int32;
+	for (const FFootstepPoolWindowBucket& Bucket : WindowBuckets)
+	{
+		MinIdleSlots = FMath::Min(MinIdleSlots, Bucket.MinIdleSlots);
+	}
+
+	if (MinIdleSlots != MAX_int32 && MinIdleSlots > 0 && PoolLimit > MinPoolLimit)
+	{
+		PoolLimit = FMath::Clamp(PooledActors.Num() - MinIdleSlots, MinPoolLimit, MaxPoolLimit);
+		LastResizeTime = TimeSeconds;
+	}
+}
+
+void UFootstepPoolingManager::TrimIdleActors(int32 MaxActors)
+{
+	for (int32 i = PooledActors.Num() - 1; i >= 0 && PooledActors.Num() > MaxActors; --i)
+	{
+		const TObjectPtr<AFootstepActor> Actor = PooledActors[i];
+		if (!IsValid(Actor))
+		{
+			PooledActors.RemoveAt(i);
+		}
+		else if (!Actor->IsPoolingActive())
+		{
+			Actor->Destroy();
+			PooledActors.RemoveAt(i);
+			++TotalTrimmed;
+		}
+	}
+}
@@ -0,0 +1,287 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootstepRecording.h"
+
+#if FOOTSTEP_RECORDING
+
+#include "FootstepComponent.h"
+#include "FootstepDataAsset.h"
+#include "FootstepTypes.h"
+#include "Engine/World.h"
+#include "Engine/HitResult.h"
+#include "GameFramework/Actor.h"
+#include "Sound/SoundBase.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+namespace FootstepRecording
+{
+	static constexpr uint32 FileMagic = 0x50545346; // "FSTP"
+	static constexpr uint32 FileVersion = 2;
+
+	/** The file is a stream of entries, so names are written just before the first record which uses them. */
+	enum class EEntryType : uint8
+	{
+		Name,
+		Record
+	};
+
+	struct FActiveRecording
+	{
+		TUniquePtr<FArchive> Writer;
+		TMap<FString, int32> NameIndices;
+		FString FilePath;
+		int32 NumRecords = 0;
+
+		/** Other worlds have their own time, so only footsteps of this one are recorded. */
+		TWeakObjectPtr<const UWorld> World;
+		FDelegateHandle WorldCleanupHandle;
+
+		double StartTime = -1.0;
+		uint64 StartFrame = 0;
+
+		int32 AddName(const UObject* Object)
+		{
+			return Object ? AddName(Object->GetPathName()) : INDEX_NONE;
+		}
+
+		int32 AddName(const FString& Name)
+		{
+			if (const int32* Index = NameIndices.Find(Name))
+			{
+				return *Index;
+			}
+
+			uint8 EntryType = static_cast<uint8>(EEntryType::Name);
+			FString NameToWrite = Name;
+			*Writer << EntryType;
+			*Writer << NameToWrite;
+
+			return NameIndices.Add(Name, NameIndices.Num());
+		}
+
+		void AddRecord(FFootstepRecord& Record)
+		{
+			uint8 EntryType = static_cast<uint8>(EEntryType::Record);
+			*Writer << EntryType;
+			*Writer << Record;
+			++NumRecords;
+		}
+	};
+
+	static TUniquePtr<FActiveRecording> GActiveRecording;
+
+	static void StopRecording();
+
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		if (GActiveRecording.IsValid() && GActiveRecording->World.Get() == World)
+		{
+			StopRecording();
+		}
+	}
+
+	static void StartRecording(const UWorld& World, const FString& FilePath)
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+		if (!Writer.IsValid())
+		{
+			UE_LOG(LogFootstep, Error, TEXT("Couldn't open %s for the footstep recording."), *FilePath);
+			return;
+		}
+
+		uint32 Magic = FileMagic;
+		uint32 Version = FileVersion;
+		*Writer << Magic;
+		*Writer << Version;
+
+		GActiveRecording = MakeUnique<FActiveRecording>();
+		GActiveRecording->Writer = MoveTemp(Writer);
+		GActiveRecording->FilePath = FilePath;
+		GActiveRecording->World = &World;
+		GActiveRecording->WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&OnWorldCleanup);
+
+		UE_LOG(LogFootstep, Display, TEXT("Footstep recording of %s has started, it's written to %s"), *World.GetMapName(), *FilePath);
+	}
+
+	static void StopRecording()
+	{
+		if (!GActiveRecording.IsValid())
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("There's no footstep recording to stop."));
+			return;
+		}
+
+		const TUniquePtr<FActiveRecording> Recording = MoveTemp(GActiveRecording);
+		FWorldDelegates::OnWorldCleanup.Remove(Recording->WorldCleanupHandle);
+
+		if (Recording->Writer->Close())
+		{
+			UE_LOG(LogFootstep, Display, TEXT("%d footsteps have been recorded to %s"), Recording->NumRecords, *Recording->FilePath);
+		}
+		else
+		{
+			UE_LOG(LogFootstep, Error, TEXT("Couldn't write the footstep recording to %s"), *Recording->FilePath);
+		}
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FFootstepRecord& Record)
+{
+	Ar << Record.Time;
+	Ar << Record.Frame;
+	Ar << Record.SocketLocation;
+	Ar << Record.TraceDirection;
+	Ar << Record.Location;
+	Ar << Record.Normal;
+	Ar << Record.ParticleScale;
+	Ar << Record.Volume;
+	Ar << Record.Pitch;
+	Ar << Record.Category;
+	Ar << Record.OwnerClass;
+	Ar << Record.DataAsset;
+	Ar << Record.Sound;
+	Ar << Record.Particle;
+	Ar << Record.SurfaceType;
+	Ar << Record.bPlaySound2D;
+
+	return Ar;
+}
+
+bool FFootstepRecording::Load(const FString& FilePath)
+{
+	const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader.IsValid()) { return false; }
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+
+	*Reader << Magic;
+	*Reader << Version;
+
+	if (Magic != FootstepRecording::FileMagic || Version != FootstepRecording::FileVersion) { return false; }
+
+	while (!Reader->AtEnd())
+	{
+		uint8 EntryType = 0;
+		*Reader << EntryType;
+
+		if (EntryType == static_cast<uint8>(FootstepRecording::EEntryType::Name))
+		{
+			FString Name;
+			*Reader << Name;
+
+			if (Reader->IsError()) { break; }
+
+			Names.Add(MoveTemp(Name));
+		}
+		else if (EntryType == static_cast<uint8>(FootstepRecording::EEntryType::Record))
+		{
+			FFootstepRecord Record;
+			*Reader << Record;
+
+			if (Reader->IsError()) { break; }
+
+			Records.Add(Record);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	// An entry cut off by a crash is dropped, the ones before it are still valid
+	Reader->Close();
+	return true;
+}
+
+const FString* FFootstepRecording::GetName(int32 Index) const
+{
+	return Names.IsValidIndex(Index) ? &Names[Index] : nullptr;
+}
+
+bool FootstepRecording::IsRecording()
+{
+	return GActiveRecording.IsValid();
+}
+
+void FootstepRecording::RecordFootstep(const UFootstepComponent& Component, const FFootstepRequest& Request, const FHitResult& HitResult, uint8 SurfaceType, const UFootstepDataAsset* DataAsset,
+	const USoundBase* Sound, const UFXSystemAsset* Particle, float Volume, float Pitch, const FVector& ParticleScale, bool bPlaySound2D)
+{
+	const UWorld* World = Component.GetWorld();
+	const AActor* Owner = Component.GetOwner();
+
+	if (!(GActiveRecording.IsValid() && World && Owner && GActiveRecording->World.Get() == World)) { return; }
+
+	FOOTSTEP_ALLOCATION_GUARD_SUSPEND();
+
+	FActiveRecording& ActiveRecording = *GActiveRecording;
+
+	// Time is relative to the first recorded footstep
+	if (ActiveRecording.StartTime < 0.0)
+	{
+		ActiveRecording.StartTime = World->GetTimeSeconds();
+		ActiveRecording.StartFrame = GFrameCounter;
+	}
+
+	FFootstepRecord Record;
+	Record.Time = World->GetTimeSeconds() - ActiveRecording.StartTime;
+	Record.Frame = static_cast<uint32>(GFrameCounter - ActiveRecording.StartFrame);
+	Record.SocketLocation = FVector3f(Request.TraceStart);
+	Record.TraceDirection = FVector3f(Request.TraceDirection);
+	Record.Location = FVector3f(HitResult.ImpactPoint);
+	Record.Normal = FVector3f(HitResult.ImpactNormal);
+	Record.ParticleScale = FVector3f(ParticleScale);
+	Record.Volume = Volume;
+	Record.Pitch = Pitch;
+	Record.Category = ActiveRecording.AddName(Request.Category.ToString());
+	Record.OwnerClass = ActiveRecording.AddName(Owner->GetClass());
+	Record.DataAsset = ActiveRecording.AddName(DataAsset);
+	Record.Sound = ActiveRecording.AddName(Sound);
+	Record.Particle = ActiveRecording.AddName(Particle);
+	Record.SurfaceType = SurfaceType;
+	Record.bPlaySound2D = bPlaySound2D;
+
+	ActiveRecording.AddRecord(Record);
+}
+
+void FootstepRecording::Shutdown()
+{
+	if (GActiveRecording.IsValid())
+	{
+		StopRecording();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GFootstepRecordStartCommand(
+	TEXT("Footstep.Record.Start"),
+	TEXT("Starts recording footsteps of the current world which reach the Footstep Pooling Manager. Arguments: FileName (default Footsteps_<date>.footsteps in the Profiling/Footstep directory)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (FootstepRecording::IsRecording())
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footsteps are already being recorded."));
+			return;
+		}
+
+		if (!(World && World->IsGameWorld()))
+		{
+			UE_LOG(LogFootstep, Warning, TEXT("Footsteps have to be recorded in a game world."));
+			return;
+		}
+
+		const FString FileName = Args.Num() > 0 ? Args[0] : FString::Printf(TEXT("Footsteps_%s.footsteps"), *FDateTime::Now().ToString());
+		const FString FilePath = FPaths::IsRelative(FileName) ? FPaths::ProfilingDir() / TEXT("Footstep") / FileName : FileName;
+
+		FootstepRecording::StartRecording(*World, FilePath);
+	})
+);
+
+static FAutoConsoleCommand GFootstepRecordStopCommand(
+	TEXT("Footstep.Record.Stop"),
+	TEXT("Stops recording footsteps and closes the recording file."),
+	FConsoleCommandDelegate::CreateStatic(&FootstepRecording::StopRecording)
+);
+
+#endif
@@ -0,0 +1,133 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootstepScalability.h"
+#include "SurfaceFootstepSystemSettings.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarFootstepMaxPoolSize(
+	TEXT("Footstep.MaxPoolSize"),
+	0,
+	TEXT("Maximum amount of Footstep Actors. 0 means that only the pooling settings from the Surface Footstep System Settings are used."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarFootstepCullDistance(
+	TEXT("Footstep.CullDistance"),
+	0.f,
+	TEXT("Footsteps farther from every local player's view won't generate any FX. 0 disables culling."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<bool> CVarFootstepSpawnParticles(
+	TEXT("Footstep.SpawnParticles"),
+	true,
+	TEXT("Whether footstep particles should be spawned."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<int32> CVarFootstepMaxPerFrame(
+	TEXT("Footstep.MaxPerFrame"),
+	0,
+	TEXT("Maximum amount of footsteps with FX in a single frame. 0 means no limit."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<bool> CVarFootstepAsyncTrace(
+	TEXT("Footstep.AsyncTrace"),
+	false,
+	TEXT("Whether footstep surface traces should be asynchronous. The footstep is generated in the next frame, when the trace is finished."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<bool> CVarFootstepBatch(
+	TEXT("Footstep.Batch"),
+	false,
+	TEXT("Whether footsteps should be collected during the frame and resolved in one batch, with culling, traces and random choices running in parallel. Takes precedence over Footstep.AsyncTrace."),
+	ECVF_Default);
+
+namespace FootstepScalability
+{
+	static FConsoleVariableSinkHandle ScalabilitySinkHandle;
+	static int32 AppliedEffectsQuality = INDEX_NONE;
+
+	static int32 GetEffectsQuality()
+	{
+		static const IConsoleVariable* CVarEffectsQuality = IConsoleManager::Get().FindConsoleVariable(TEXT("sg.EffectsQuality"));
+
+		return CVarEffectsQuality ? CVarEffectsQuality->GetInt() : INDEX_NONE;
+	}
+
+	static void OnConsoleVariablesChanged()
+	{
+		if (GetEffectsQuality() != AppliedEffectsQuality)
+		{
+			ApplyQualityLevel();
+		}
+	}
+}
+
+int32 FootstepScalability::GetMaxPoolSize()
+{
+	const int32 MaxPoolSize = CVarFootstepMaxPoolSize.GetValueOnGameThread();
+	return MaxPoolSize > 0 ? MaxPoolSize : INDEX_NONE;
+}
+
+float FootstepScalability::GetCullDistance()
+{
+	const float CullDistance = CVarFootstepCullDistance.GetValueOnGameThread();
+	return CullDistance > 0.f ? CullDistance : 0.f;
+}
+
+bool FootstepScalability::GetSpawnParticles()
+{
+	return CVarFootstepSpawnParticles.GetValueOnGameThread();
+}
+
+int32 FootstepScalability::GetMaxFootstepsPerFrame()
+{
+	const int32 MaxFootstepsPerFrame = CVarFootstepMaxPerFrame.GetValueOnGameThread();
+	return MaxFootstepsPerFrame > 0 ? MaxFootstepsPerFrame : INDEX_NONE;
+}
+
+bool FootstepScalability::GetAsyncTrace()
+{
+	return CVarFootstepAsyncTrace.GetValueOnGameThread();
+}
+
+bool FootstepScalability::GetBatch()
+{
+	return CVarFootstepBatch.GetValueOnGameThread();
+}
+
+void FootstepScalability::Initialize()
+{
+	if (!ScalabilitySinkHandle.IsValid())
+	{
+		ScalabilitySinkHandle = IConsoleManager::Get().RegisterConsoleVariableSink_Handle(FConsoleCommandDelegate::CreateStatic(&OnConsoleVariablesChanged));
+	}
+}
+
+void FootstepScalability::Shutdown()
+{
+	if (ScalabilitySinkHandle.IsValid())
+	{
+		IConsoleManager::Get().UnregisterConsoleVariableSink_Handle(ScalabilitySinkHandle);
+		ScalabilitySinkHandle = FConsoleVariableSinkHandle();
+	}
+
+	AppliedEffectsQuality = INDEX_NONE;
+}
+
+void FootstepScalability::ApplyQualityLevel()
+{
+	const int32 EffectsQuality = GetEffectsQuality();
+	AppliedEffectsQuality = EffectsQuality;
+
+	const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+	if (!(FootstepSettings && FootstepSettings->GetApplyQualityLevels() && EffectsQuality != INDEX_NONE)) { return; }
+
+	if (const FFootstepQualityLevel* QualityLevel = FootstepSettings->GetQualityLevel(EffectsQuality))
+	{
+		// Scalability priority, so device profiles and the console still win
+		CVarFootstepMaxPoolSize->Set(QualityLevel->MaxPoolSize, ECVF_SetByScalability);
+		CVarFootstepCullDistance->Set(QualityLevel->CullDistance, ECVF_SetByScalability);
+		CVarFootstepSpawnParticles->Set(QualityLevel->bSpawnParticles, ECVF_SetByScalability);
+		CVarFootstepMaxPerFrame->Set(QualityLevel->MaxFootstepsPerFrame, ECVF_SetByScalability);
+		CVarFootstepAsyncTrace->Set(QualityLevel->bAsyncTrace, ECVF_SetByScalability);
+	}
+}
@@ -0,0 +1,43 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#include "FootstepTrace.h"
+
+#if FOOTSTEP_TRACE_ENABLED
+
+#include "GameFramework/Actor.h"
+#include "GameplayTagContainer.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(FootstepChannel);
+
+UE_TRACE_EVENT_BEGIN(Footstep, Footstep)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, OwnerId)
+	UE_TRACE_EVENT_FIELD(int32, PoolSlot)
+	UE_TRACE_EVENT_FIELD(uint8, SurfaceType)
+	UE_TRACE_EVENT_FIELD(bool, Hit)
+	UE_TRACE_EVENT_FIELD(bool, SyncLoad)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Category)
+UE_TRACE_EVENT_END()
+
+void FootstepTrace::OutputFootstep(const AActor* Owner, uint8 SurfaceType, const FGameplayTag& Category, bool bHit, int32 PoolSlot, bool bSyncLoad)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(FootstepChannel)) { return; }
+
+	TCHAR CategoryName[FName::StringBufferSize];
+	const uint32 CategoryNameLen = Category.GetTagName().ToString(CategoryName);
+
+	UE_TRACE_LOG(Footstep, Footstep, FootstepChannel)
+		<< Footstep.Cycle(FPlatformTime::Cycles64())
+		<< Footstep.OwnerId(Owner ? Owner->GetUniqueID() : 0)
+		<< Footstep.PoolSlot(PoolSlot)
+		<< Footstep.SurfaceType(SurfaceType)
+		<< Footstep.Hit(bHit)
+		<< Footstep.SyncLoad(bSyncLoad)
+		<< Footstep.Category(CategoryName, CategoryNameLen);
+
+	// Timing Insights has no analyzer for the Footstep event, so it's also marked with a bookmark. Its format is registered once and the fields are sent as arguments
+	TRACE_BOOKMARK(TEXT("Footstep %s Surface=%u Slot=%d Owner=%u Hit=%d SyncLoad=%d"), CategoryName, static_cast<uint32>(SurfaceType), PoolSlot, Owner ? Owner->GetUniqueID() : 0, bHit ? 1 : 0, bSyncLoad ? 1 : 0);
+}
+
+#endif
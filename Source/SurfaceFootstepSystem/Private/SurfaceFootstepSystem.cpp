@@ -3,20 +3,79 @@
 #include "SurfaceFootstepSystem.h"
 #include "SurfaceFootstepSystemSettings.h"
 #include "FootstepTypes.h"
+#include "FootstepScalability.h"
+#include "FootstepDataAsset.h"
+#include "FootstepRecording.h"
+#include "Engine/AssetManager.h"
 #include "Developer/Settings/Public/ISettingsModule.h"
 #include "Developer/Settings/Public/ISettingsSection.h"
 
 DEFINE_LOG_CATEGORY(LogFootstep);
 
+LLM_DEFINE_TAG(Footstep);
+
+DEFINE_STAT(STAT_FootstepNotify);
+DEFINE_STAT(STAT_FootstepTrace);
+DEFINE_STAT(STAT_FootstepSurfaceLookup);
+DEFINE_STAT(STAT_FootstepDataSelection);
+DEFINE_STAT(STAT_FootstepPoolAcquire);
+DEFINE_STAT(STAT_FootstepActorInit);
+DEFINE_STAT(STAT_FootstepSyncLoad);
+DEFINE_STAT(STAT_FootstepBatch);
+
+DEFINE_STAT(STAT_FootstepCount);
+DEFINE_STAT(STAT_FootstepEvictions);
+DEFINE_STAT(STAT_FootstepCulled);
+DEFINE_STAT(STAT_FootstepSyncLoads);
+DEFINE_STAT(STAT_FootstepAsyncLoads);
+
+CSV_DEFINE_CATEGORY_MODULE(SURFACEFOOTSTEPSYSTEM_API, Footstep, true);
+
+static uint32 GNumFootstepSyncLoads = 0;
+
+void FootstepAsset::OnSyncLoad()
+{
+	++GNumFootstepSyncLoads;
+	INC_DWORD_STAT(STAT_FootstepSyncLoads);
+}
+
+uint32 FootstepAsset::GetNumSyncLoads()
+{
+	return GNumFootstepSyncLoads;
+}
+
+void FootstepAsset::OnAsyncLoadRequested()
+{
+	INC_DWORD_STAT(STAT_FootstepAsyncLoads);
+	CSV_CUSTOM_STAT(Footstep, AsyncLoadsRequested, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void FootstepAsset::OnAsyncLoadCompleted()
+{
+	DEC_DWORD_STAT(STAT_FootstepAsyncLoads);
+}
+
 #define LOCTEXT_NAMESPACE "FSurfaceFootstepSystemModule"
 
 void FSurfaceFootstepSystemModule::StartupModule()
 {
 	RegisterSettings();
+	FootstepScalability::Initialize();
+	UAssetManager::CallOrRegister_OnAssetManagerCreated(FSimpleMulticastDelegate::FDelegate::CreateStatic(&FSurfaceFootstepSystemModule::RegisterPrimaryAssetType));
+
+#if FOOTSTEP_ALLOCATION_GUARD
+	FootstepAllocationGuard::Initialize();
+#endif
 }
 
 void FSurfaceFootstepSystemModule::ShutdownModule()
 {
+	FootstepScalability::Shutdown();
+
+#if FOOTSTEP_RECORDING
+	FootstepRecording::Shutdown();
+#endif
+
 	if (UObjectInitialized())
 	{
 		UnregisterSettings();
@@ -28,6 +87,7 @@ bool FSurfaceFootstepSystemModule::HandleSettingsSaved()
 	if (USurfaceFootstepSystemSettings* Settings = GetMutableDefault<USurfaceFootstepSystemSettings>())
 	{
 		Settings->SaveConfig();
+		FootstepScalability::ApplyQualityLevel();
 		return true;
 	}
 	return false;
@@ -58,6 +118,33 @@ void FSurfaceFootstepSystemModule::UnregisterSettings()
 	}
 }
 
+void FSurfaceFootstepSystemModule::RegisterPrimaryAssetType()
+{
+	const USurfaceFootstepSystemSettings* FootstepSettings = USurfaceFootstepSystemSettings::Get();
+	if (!(FootstepSettings && FootstepSettings->GetRegisterPrimaryAssetType() && UAssetManager::IsInitialized())) { return; }
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+
+	// Rules from the Asset Manager settings of the project take precedence
+	FPrimaryAssetTypeInfo TypeInfo;
+	if (AssetManager.GetPrimaryAssetTypeInfo(UFootstepDataAsset::PrimaryAssetType, TypeInfo)) { return; }
+
+	TArray<FString> Paths;
+	for (const FDirectoryPath& Directory : FootstepSettings->GetPrimaryAssetDirectories())
+	{
+		if (!Directory.Path.IsEmpty())
+		{
+			Paths.Add(Directory.Path);
+		}
+	}
+
+	if (Paths.Num() > 0)
+	{
+		constexpr bool bHasBlueprintClasses = false;
+		AssetManager.ScanPathsForPrimaryAssets(UFootstepDataAsset::PrimaryAssetType, Paths, UFootstepDataAsset::StaticClass(), bHasBlueprintClasses);
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
 	
 IMPLEMENT_MODULE(FSurfaceFootstepSystemModule, SurfaceFootstepSystem)
\ No newline at end of file
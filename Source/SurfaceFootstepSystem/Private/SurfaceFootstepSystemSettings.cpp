@@ -6,15 +6,44 @@
 USurfaceFootstepSystemSettings::USurfaceFootstepSystemSettings(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, DefaultTraceLength(50.f)
+	, CoalescingWindow(0.02f)
+	, MinNotifyWeight(0.f)
+	, bResequenceThrottledFootsteps(true)
+	, bDowngradeThrottledFootsteps(false)
 	, MaxPoolSize(20)
+	, AdaptivePoolSizeCeiling(100)
+	, AdaptivePoolWindow(5.f)
+	, AdaptivePoolTrimCooldown(10.f)
 	, DefaultFootstepActorLifeSpan(3.f)
+	, PrewarmPoolSize(0)
+	, bCarryPoolAcrossTravel(true)
+	, NoiseEventTag(TEXT("Footstep"))
+	, bRegisterPrimaryAssetType(true)
+	, MaxFootprints(256)
+	, bApplyQualityLevels(true)
 	, bPlaySound2D_ForLocalPlayer(true)
 {
 	FootstepCategories.Add(FGameplayTag::EmptyTag);
 
+	PrimaryAssetDirectories.Add({ TEXT("/Game") });
+
 	FootstepObjectTypes.Add(ECC_WorldStatic);
 	FootstepObjectTypes.Add(ECC_WorldDynamic);
 
+	// Low, Medium, High, Epic, Cinematic
+	QualityLevels.SetNum(5);
+	QualityLevels[0].MaxPoolSize = 10;
+	QualityLevels[0].CullDistance = 3000.f;
+	QualityLevels[0].bSpawnParticles = false;
+	QualityLevels[0].MaxFootstepsPerFrame = 8;
+	QualityLevels[0].bAsyncTrace = true;
+	QualityLevels[1].MaxPoolSize = 15;
+	QualityLevels[1].CullDistance = 5000.f;
+	QualityLevels[1].MaxFootstepsPerFrame = 16;
+	QualityLevels[1].bAsyncTrace = true;
+	QualityLevels[2].CullDistance = 8000.f;
+	QualityLevels[2].MaxFootstepsPerFrame = 32;
+
 	DefaultAttenuationOverride.SetPath(TEXT("/SurfaceFootstepSystem/FootstepAttenuationExample.FootstepAttenuationExample"));
 	DefaultConcurrencyOverride.SetPath(TEXT("/SurfaceFootstepSystem/FootstepConcurrencyExample.FootstepConcurrencyExample"));
 }
@@ -39,6 +68,11 @@ FGameplayTag USurfaceFootstepSystemSettings::GetCategoryName(int32 Index) const
 	return FootstepCategories.IsValidIndex(Index) ? FootstepCategories[Index] : FGameplayTag::EmptyTag;
 }
 
+int32 USurfaceFootstepSystemSettings::GetCategoryIndex(const FGameplayTag& CategoryTag) const
+{
+	return FootstepCategories.IndexOfByKey(CategoryTag);
+}
+
 const TArray<TEnumAsByte<ECollisionChannel>>& USurfaceFootstepSystemSettings::GetFootstepObjectTypes() const
 {
 	return FootstepObjectTypes;
@@ -54,16 +88,101 @@ bool USurfaceFootstepSystemSettings::GetTraceComplex() const
 	return bTraceComplex;
 }
 
+float USurfaceFootstepSystemSettings::GetCoalescingWindow() const
+{
+	return CoalescingWindow;
+}
+
+float USurfaceFootstepSystemSettings::GetMinNotifyWeight() const
+{
+	return MinNotifyWeight;
+}
+
+bool USurfaceFootstepSystemSettings::GetResequenceThrottledFootsteps() const
+{
+	return bResequenceThrottledFootsteps;
+}
+
+bool USurfaceFootstepSystemSettings::GetDowngradeThrottledFootsteps() const
+{
+	return bDowngradeThrottledFootsteps;
+}
+
 int32 USurfaceFootstepSystemSettings::GetPoolSize() const
 {
 	return MaxPoolSize > 1 ? MaxPoolSize : 1;
 }
 
+bool USurfaceFootstepSystemSettings::GetAdaptivePoolSize() const
+{
+	return bAdaptivePoolSize;
+}
+
+int32 USurfaceFootstepSystemSettings::GetPoolSizeCeiling() const
+{
+	return bAdaptivePoolSize ? FMath::Max(AdaptivePoolSizeCeiling, GetPoolSize()) : GetPoolSize();
+}
+
+float USurfaceFootstepSystemSettings::GetAdaptivePoolWindow() const
+{
+	return AdaptivePoolWindow > 0.1f ? AdaptivePoolWindow : 0.1f;
+}
+
+float USurfaceFootstepSystemSettings::GetAdaptivePoolTrimCooldown() const
+{
+	return AdaptivePoolTrimCooldown > 0.f ? AdaptivePoolTrimCooldown : 0.f;
+}
+
 float USurfaceFootstepSystemSettings::GetDefaultPoolingLifeSpan() const
 {
 	return DefaultFootstepActorLifeSpan > 0.f ? DefaultFootstepActorLifeSpan : 0.f;
 }
 
+int32 USurfaceFootstepSystemSettings::GetPrewarmPoolSize() const
+{
+	return PrewarmPoolSize > 0 ? PrewarmPoolSize : 0;
+}
+
+bool USurfaceFootstepSystemSettings::GetCarryPoolAcrossTravel() const
+{
+	return bCarryPoolAcrossTravel;
+}
+
+bool USurfaceFootstepSystemSettings::GetReportNoiseEvents() const
+{
+	return bReportNoiseEvents;
+}
+
+FName USurfaceFootstepSystemSettings::GetNoiseEventTag() const
+{
+	return NoiseEventTag;
+}
+
+bool USurfaceFootstepSystemSettings::GetRegisterPrimaryAssetType() const
+{
+	return bRegisterPrimaryAssetType;
+}
+
+const TArray<FDirectoryPath>& USurfaceFootstepSystemSettings::GetPrimaryAssetDirectories() const
+{
+	return PrimaryAssetDirectories;
+}
+
+int32 USurfaceFootstepSystemSettings::GetMaxFootprints() const
+{
+	return MaxFootprints > 1 ? MaxFootprints : 1;
+}
+
+bool USurfaceFootstepSystemSettings::GetApplyQualityLevels() const
+{
+	return bApplyQualityLevels;
+}
+
+const FFootstepQualityLevel* USurfaceFootstepSystemSettings::GetQualityLevel(int32 EffectsQuality) const
+{
+	return QualityLevels.Num() > 0 ? &QualityLevels[FMath::Clamp(EffectsQuality, 0, QualityLevels.Num() - 1)] : nullptr;
+}
+
 bool USurfaceFootstepSystemSettings::GetPlaySound2D() const
 {
 	return bPlaySound2D_ForLocalPlayer;
@@ -78,3 +197,8 @@ FString USurfaceFootstepSystemSettings::GetConcurrencyAssetPath() const
 {
 	return DefaultConcurrencyOverride.GetAssetPathString();
 }
+
+const FFootstepVoiceParameters& USurfaceFootstepSystemSettings::GetVoiceParameters() const
+{
+	return VoiceParameters;
+}
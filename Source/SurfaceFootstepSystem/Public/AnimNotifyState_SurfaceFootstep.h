@@ -0,0 +1,54 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "GameplayTagContainer.h"
+#include "AnimNotify_SurfaceFootstep.h"
+#include "AnimNotifyState_SurfaceFootstep.generated.h"
+
+class USurfaceFootstepSystemSettings;
+
+/**
+ * An anim notify state from the Surface Footstep System plugin which resolves a footstep surface ahead of the contact frame.
+ * It should begin a little before the foot lands (for example 50-100 ms) and end on the contact frame. At the beginning, an asynchronous trace is issued
+ * from the foot socket location predicted with the owner's velocity, and the surface, Data Asset and assets are cached. At the end, only the FX activation is left.
+ */
+UCLASS(NotBlueprintable, NotBlueprintType, meta = (DisplayName = "Surface Footstep (Predictive)"))
+class SURFACEFOOTSTEPSYSTEM_API UAnimNotifyState_SurfaceFootstep : public UAnimNotifyState
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	/** Has to be one of the names from the Surface Footstep System Settings in the Project Settings. */
+	UPROPERTY(EditAnywhere, Category = "AnimNotify", meta = (Categories = "Footstep"))
+	FGameplayTag FootstepCategory;
+
+	/** If the socket is not rotated, "Down" direction should be used most of the time, but in some cases (for instance, wall climbing or falling on the floor) you might want to change a trace direction. */
+	UPROPERTY(EditAnywhere, Category = "AnimNotify")
+	EFootstepTraceDirection FootstepTraceDirection;
+
+	/** If false, trace will start at Root socket location. */
+	UPROPERTY(EditAnywhere, Category = "AnimNotify")
+	bool bTraceFromFootSocket;
+
+	/** A socket name from which a trace will be created. If it doesn't exist in the skeletal mesh, Root socket will be used. */
+	UPROPERTY(EditAnywhere, Category = "AnimNotify", meta = (EditCondition = bTraceFromFootSocket))
+	FName FootSocket;
+
+	//~ Begin UAnimNotifyState Interface
+	virtual void NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference) override;
+	virtual void NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	virtual FString GetNotifyName_Implementation() const override;
+	//~ End UAnimNotifyState Interface
+
+private:
+	UPROPERTY()
+	TObjectPtr<USurfaceFootstepSystemSettings> FootstepSettings;
+
+	bool TraceFromFootSocket() const;
+
+	/** Whether the notify timeline has reached the end of the state, rather than the state being cut short. */
+	static bool HasReachedEnd(const UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference);
+};
@@ -6,10 +6,11 @@
 #include "Animation/AnimNotifies/AnimNotify.h"
 #include "GameplayTagContainer.h"
 #include "Engine/EngineTypes.h"
+#include "FootstepTypes.h"
 #include "AnimNotify_SurfaceFootstep.generated.h"
 
 class USurfaceFootstepSystemSettings;
-class UPhysicalMaterial;
+class UFootstepComponent;
 
 UENUM()
 enum class EFootstepTraceDirection : uint8
@@ -52,10 +53,22 @@ public:
 	virtual FString GetNotifyName_Implementation() const override;
 	//~ End UAnimNotify Interface
 
+	/** Returns the active Footstep Component of the mesh owner, if a footstep of the given category can be generated for it. Shared by all Surface Footstep notifies. */
+	static UFootstepComponent* FindFootstepComponent(USkeletalMeshComponent* MeshComp, const FGameplayTag& InFootstepCategory);
+
+	/** Makes a footstep request traced from the foot socket, or from the mesh if the socket is none or doesn't exist. */
+	static FFootstepRequest MakeFootstepRequest(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FGameplayTag& InFootstepCategory, EFootstepTraceDirection InTraceDirection, FName InFootSocket);
+
+	/** Blend weight of the montage which fired the notify. Other notifies are treated as fully weighted. */
+	static float GetNotifyWeight(USkeletalMeshComponent* MeshComp, const FAnimNotifyEventReference& EventReference);
+
+	/** Marks the request as throttled if the mesh skips animation ticks because of Update Rate Optimizations or the Animation Budget Allocator,
+	and sets how late the notify has been fired, measured on the notify timeline. */
+	static void SetThrottling(FFootstepRequest& Request, USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference);
+
 private:
 	UPROPERTY()
 	TObjectPtr<USurfaceFootstepSystemSettings> FootstepSettings;
 
 	bool TraceFromFootSocket() const;
-	FString GetActorName(const AActor* Actor) const;
 };
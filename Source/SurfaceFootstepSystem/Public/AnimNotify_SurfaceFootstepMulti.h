@@ -0,0 +1,47 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+#include "GameplayTagContainer.h"
+#include "AnimNotify_SurfaceFootstep.h"
+#include "AnimNotify_SurfaceFootstepMulti.generated.h"
+
+class USurfaceFootstepSystemSettings;
+
+/**
+ * An anim notify from the Surface Footstep System plugin for quadrupeds and creatures which place several feet on the same frame.
+ * The Footstep Component and the category are resolved once, and the traces of all feet are resolved in one pass with shared trace parameters.
+ */
+UCLASS(NotBlueprintable, NotBlueprintType, meta = (DisplayName = "Surface Footstep (Multiple Feet)"))
+class SURFACEFOOTSTEPSYSTEM_API UAnimNotify_SurfaceFootstepMulti : public UAnimNotify
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	/** Has to be one of the names from the Surface Footstep System Settings in the Project Settings. */
+	UPROPERTY(EditAnywhere, Category = "AnimNotify", meta = (Categories = "Footstep"))
+	FGameplayTag FootstepCategory;
+
+	/** If the sockets are not rotated, "Down" direction should be used most of the time. */
+	UPROPERTY(EditAnywhere, Category = "AnimNotify")
+	EFootstepTraceDirection FootstepTraceDirection;
+
+	/** Sockets of all feet which land on this frame. If a socket doesn't exist in the skeletal mesh, Root socket will be used for its trace. */
+	UPROPERTY(EditAnywhere, Category = "AnimNotify")
+	TArray<FName> FootSockets;
+
+	/** Whether feet which land on the same Surface Type should play a single sound. Every foot still spawns its own particles and footprints. */
+	UPROPERTY(EditAnywhere, Category = "AnimNotify")
+	bool bMergeSameSurface;
+
+	//~ Begin UAnimNotify Interface
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	virtual FString GetNotifyName_Implementation() const override;
+	//~ End UAnimNotify Interface
+
+private:
+	UPROPERTY()
+	TObjectPtr<USurfaceFootstepSystemSettings> FootstepSettings;
+};
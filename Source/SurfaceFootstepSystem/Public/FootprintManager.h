@@ -0,0 +1,73 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FootprintManager.generated.h"
+
+class UStaticMesh;
+class UMaterialInterface;
+class UInstancedStaticMeshComponent;
+
+/**
+ * Footprints which share the same mesh and material. Instances are used as a ring buffer.
+ */
+USTRUCT()
+struct FFootprintBatch
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UStaticMesh> Mesh;
+
+	UPROPERTY()
+	TObjectPtr<UMaterialInterface> Material;
+
+	UPROPERTY()
+	TObjectPtr<UInstancedStaticMeshComponent> Component;
+
+	/** The instance which will be recycled by the next footprint. */
+	int32 NextInstance = 0;
+
+	bool bRenderStateDirty = false;
+};
+
+/**
+ * A subsystem from the Surface Footstep System plugin which renders footprints with one Instanced Static Mesh Component per footprint mesh and material.
+ */
+UCLASS(NotBlueprintable, NotBlueprintType)
+class SURFACEFOOTSTEPSYSTEM_API UFootprintManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Removes all footprints. */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Surface Footstep System", meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext))
+	static void ClearFootprints(const UObject* WorldContextObject);
+
+	//~ Begin USubsystem Interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/** Writes a footprint into the ring buffer of its batch. When the buffer is full, the oldest footprint is recycled. */
+	void AddFootprint(UStaticMesh* Mesh, UMaterialInterface* Material, const FTransform& Transform, float LifeSpan);
+	void DestroyFootprints();
+
+	UFootprintManager();
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> FootprintActor;
+
+	UPROPERTY(Transient)
+	TArray<FFootprintBatch> FootprintBatches;
+
+	FFootprintBatch* FindOrAddBatch(UStaticMesh* Mesh, UMaterialInterface* Material);
+};
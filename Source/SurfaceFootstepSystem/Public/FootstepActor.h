@@ -26,6 +26,7 @@ private:
 	UPROPERTY()
 	TObjectPtr<UAudioComponent> AudioComponent;
 
+	/** Not created if bWithCascade is False in the [SurfaceFootstepSystem] section of DefaultEngine.ini. */
 	UPROPERTY()
 	TObjectPtr<UParticleSystemComponent> ParticleComponent;
 
@@ -33,20 +34,20 @@ private:
 	TObjectPtr<UNiagaraComponent> NiagaraComponent;
 
 public:
-	//~ Begin AActor interface
-	virtual void SetLifeSpan(float InLifespan) override;
-	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
-	//~ End AActor interface
-
 	void SetPoolingActive(bool bInActive);
 	bool IsPoolingActive() const;
+	uint32 GetPoolingSerial() const;
+	bool IsPlayingSound(USoundConcurrency* Concurrency) const;
 
-	void InitSound(USoundBase* Sound, float Volume, float Pitch, bool bIs2D, USoundAttenuation* AttenuationOverride = nullptr, USoundConcurrency* ConcurrencyOverride = nullptr) const;
-	void InitParticle(UFXSystemAsset* Particle, const FVector& RelativeScale) const;
+	void InitSound(USoundBase* Sound, float Volume, float Pitch, bool bIs2D, USoundAttenuation* AttenuationOverride = nullptr, USoundConcurrency* ConcurrencyOverride = nullptr);
+	void InitParticle(UFXSystemAsset* Particle, const FVector& RelativeScale);
 
 private:
-	FName UseComponentTag;
-	float PoolingLifeSpan;
-	FTimerHandle PoolingTimer;
+	uint32 PoolingSerial;
 	bool bPoolingActive;
+
+	/** Which components have been initialized for the next activation. Flags instead of component tags, so initialization doesn't touch any arrays. */
+	bool bUseAudio;
+	bool bUseCascade;
+	bool bUseNiagara;
 };
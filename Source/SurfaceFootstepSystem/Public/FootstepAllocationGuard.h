@@ -0,0 +1,54 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define FOOTSTEP_ALLOCATION_GUARD !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+#if FOOTSTEP_ALLOCATION_GUARD
+
+/**
+ * Debug mode which reports every heap allocation made by the steady-state footstep path, enabled with -FootstepAllocationGuard.
+ * The allocator is wrapped only when the mode is enabled, so it costs nothing otherwise.
+ * The wrapper is installed when the module starts up, while other threads may already be allocating, so the mode is a local debugging and benchmarking aid only
+ * and shouldn't be enabled in shipped or shared runs. The footstep benchmarks count allocations with it.
+ */
+namespace FootstepAllocationGuard
+{
+	void Initialize();
+	SURFACEFOOTSTEPSYSTEM_API bool IsEnabled();
+
+	/** Heap allocations made by the current thread since the mode has been enabled, used by the footstep benchmarks. Always 0 if the mode is disabled. */
+	SURFACEFOOTSTEPSYSTEM_API uint64 GetNumThreadAllocations();
+}
+
+/** Counts heap allocations made by the current thread while it's alive and reports them when the outermost scope ends. */
+class SURFACEFOOTSTEPSYSTEM_API FFootstepAllocationGuardScope
+{
+public:
+	explicit FFootstepAllocationGuardScope(const TCHAR* InName);
+	~FFootstepAllocationGuardScope();
+
+private:
+	const TCHAR* Name;
+	uint32 StartAllocations;
+};
+
+/** Allocations made while it's alive aren't reported, for instance loading, pool growth or FX activation, which aren't a part of the steady state. */
+class SURFACEFOOTSTEPSYSTEM_API FFootstepAllocationGuardSuspendScope
+{
+public:
+	FFootstepAllocationGuardSuspendScope();
+	~FFootstepAllocationGuardSuspendScope();
+};
+
+#define FOOTSTEP_ALLOCATION_GUARD_SCOPE(Name) FFootstepAllocationGuardScope ANONYMOUS_VARIABLE(FootstepAllocationGuard)(Name)
+#define FOOTSTEP_ALLOCATION_GUARD_SUSPEND() FFootstepAllocationGuardSuspendScope ANONYMOUS_VARIABLE(FootstepAllocationGuardSuspend)
+
+#else
+
+#define FOOTSTEP_ALLOCATION_GUARD_SCOPE(Name)
+#define FOOTSTEP_ALLOCATION_GUARD_SUSPEND()
+
+#endif
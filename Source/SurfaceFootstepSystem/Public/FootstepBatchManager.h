@@ -0,0 +1,70 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CollisionQueryParams.h"
+#include "Engine/HitResult.h"
+#include "FootstepTypes.h"
+#include "FootstepDataAsset.h"
+#include "FootstepBatchManager.generated.h"
+
+class UFootstepComponent;
+class UPhysicalMaterial;
+
+/**
+ * A footstep collected by the Footstep Batch Manager, together with the results of its parallel stages.
+ */
+struct FFootstepBatchEntry
+{
+	TWeakObjectPtr<UFootstepComponent> Component;
+	FFootstepRequest Request;
+	FVector TraceEnd = FVector::ZeroVector;
+	FCollisionQueryParams QueryParams;
+	FCollisionObjectQueryParams ObjectParams;
+	bool bGenerateEvents = false;
+
+	/** Feet requested together with bMergeSameSurface share a non-zero group of their component. They are queued one after another. */
+	uint32 MergeGroup = 0;
+
+	bool bInCullDistance = false;
+	bool bHit = false;
+	FHitResult HitResult;
+	const UPhysicalMaterial* PhysMat = nullptr;
+	const TSoftObjectPtr<UFootstepDataAsset>* DataAssetPtr = nullptr;
+	const UFootstepDataAsset* DataAsset = nullptr;
+	FFootstepVariation Variation;
+};
+
+/**
+ * A subsystem from the Surface Footstep System plugin which resolves all footsteps of a frame in one batch, if Footstep.Batch is enabled.
+ * Culling, traces, surface lookup and random choices run in parallel, and only loading and the FX application stay on the game thread.
+ */
+UCLASS(NotBlueprintable, NotBlueprintType)
+class SURFACEFOOTSTEPSYSTEM_API UFootstepBatchManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem Interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/** Queues a footstep, which will be resolved at the end of the frame. Footsteps with the same non-zero MergeGroup play one sound per Surface Type. */
+	void AddFootstep(UFootstepComponent* Component, const FFootstepRequest& Request, bool bGenerateEvents, uint32 MergeGroup = 0);
+
+	UFootstepBatchManager();
+
+private:
+	TArray<FFootstepBatchEntry> PendingFootsteps;
+	TArray<FFootstepBatchEntry> ProcessingFootsteps;
+
+	void ProcessFootsteps();
+};
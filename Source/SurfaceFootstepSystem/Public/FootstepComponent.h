@@ -5,11 +5,63 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Chaos/ChaosEngineInterface.h"
+#include "WorldCollision.h"
+#include "Engine/HitResult.h"
+#include "Engine/TimerHandle.h"
+#include "FootstepTypes.h"
+#include "FootstepDataAsset.h"
 #include "FootstepComponent.generated.h"
 
-struct FHitResult;
 class UFootstepDataAsset;
+class UPhysicalMaterial;
 class USurfaceFootstepSystemSettings;
+class USoundBase;
+class UAudioComponent;
+struct FPrimaryAssetId;
+
+/** A footstep waiting for the result of an asynchronous trace. */
+struct FFootstepPendingTrace
+{
+	FFootstepRequest Request;
+	FTraceHandle TraceHandle;
+	bool bGenerateFX = false;
+
+	/** Feet requested together with bMergeSameSurface share a non-zero group, and are generated together when the last of their traces completes. */
+	uint32 MergeGroup = 0;
+	bool bResolved = false;
+	FHitResult HitResult;
+};
+
+/** A footstep whose surface is resolved ahead of its contact frame. */
+struct FFootstepPreparedTrace
+{
+	FFootstepRequest Request;
+	FTraceHandle TraceHandle;
+
+	bool bResolved = false;
+	FHitResult HitResult;
+	FFootstepVariation Variation;
+};
+
+/** A footstep of a throttled mesh, delayed to keep its spacing from the notify timeline. */
+struct FFootstepDelayedRequest
+{
+	FFootstepRequest Request;
+	double ReleaseTime = 0.0;
+
+	/** Whether the footstep waits for its Coalescing Window to close, so a notify with a higher weight can still replace it. */
+	bool bCoalescing = false;
+};
+
+/** The Coalescing Window of a foot socket. */
+struct FFootstepCoalescingWindow
+{
+	FName SocketName;
+	double StartTime = 0.0;
+
+	/** The weight of the footstep which wins the window so far. */
+	float Weight = 0.f;
+};
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_EightParams(FFootstepDelegate, TEnumAsByte<EPhysicalSurface>, SurfaceType, const FGameplayTag&, Category, const FTransform&, ActorTransform, float, GeneratedVolume, float, GeneratedPitch, float, GeneratedSoundAssetVolume, float, GeneratedSoundAssetPitch, const FVector&, GeneratedParticleRelativeScale);
 
@@ -30,6 +82,11 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Surface Footstep System", meta = (ClampMin = 0.f))
 	float TraceLength;
 
+	/** If set, footstep sounds are played by this MetaSound Source instead of pooled Footstep Actors. It stays active as long as the component, so active sounds scale with characters, not steps.
+	On every footstep, the inputs named in the Voice Parameters of the plugin settings are set and the trigger is executed, and the MetaSound picks the wave itself. Sounds in Footstep Data Assets are ignored then. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Surface Footstep System")
+	TSoftObjectPtr<USoundBase> FootstepVoice;
+
 	/** Will preload all footstep assets (Data Assets, Sounds, VFXes) asynchronously during registering the component and keep them in memory. */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, AdvancedDisplay, Category = "Surface Footstep System")
 	bool bPreloadAssetsAsynchronously;
@@ -64,9 +121,52 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Surface Footstep System")
 	bool RemoveActorToIgnoreForTrace(AActor* ActorToRemove);
 
+	/** Loads Footstep Data Assets of this component through the Asset Manager, together with the given bundles ("Sound", "Particle", "Footprint" or a category tag, for example "Footstep.Walk").
+	Assets of bundles which aren't listed are released. The bundle state is shared by every component using the same Data Assets. */
+	UFUNCTION(BlueprintCallable, Category = "Surface Footstep System")
+	void LoadFootstepBundles(const TArray<FName>& Bundles);
+
+	/** Releases Footstep Data Assets of this component and their bundles, which have been loaded with Load Footstep Bundles. */
+	UFUNCTION(BlueprintCallable, Category = "Surface Footstep System")
+	void UnloadFootstepBundles();
+
+	/** Resolves the surface of a footstep (synchronously or asynchronously, depending on Footstep.AsyncTrace) and generates its FX and events. */
+	void RequestFootstep(const FFootstepRequest& Request);
+
+	/** Resolves several feet which land on the same frame in one pass with shared trace parameters. If bMergeSameSurface is true,
+	only the first foot on each Surface Type plays a sound. With Footstep.AsyncTrace, merged feet are generated together when the last of their traces completes,
+	and with Footstep.Batch, they are merged when their batch is applied. */
+	void RequestFootsteps(TConstArrayView<FFootstepRequest> Requests, bool bMergeSameSurface);
+
+	/** Starts resolving the surface of an upcoming footstep with an asynchronous trace. The surface, Data Asset and random choices are cached for the foot socket.
+	Nothing is traced if the footstep would be culled and nobody listens to its events. */
+	void PrepareFootstep(const FFootstepRequest& Request);
+
+	/** Generates a footstep prepared for the same foot socket, so only the FX activation is left. If it hasn't been prepared or resolved in time, the footstep is requested as usual. */
+	void RequestPreparedFootstep(const FFootstepRequest& Request);
+
+	/** Discards the footstep prepared for the foot socket, for example because its notify state has been cut short before the contact frame. */
+	void CancelPreparedFootstep(FName SocketName);
+
 	bool CreateFootstepLineTrace(const FVector& Start, const FVector& DirectionNormalVector, FHitResult& OutHit) const;
+
+	/** Traces for a surface and returns its Physical Material. Doesn't touch any FX, so it can be used in the event-only mode on a Dedicated Server. */
+	const UPhysicalMaterial* ResolveFootstepSurface(const FVector& Start, const FVector& DirectionNormalVector, FHitResult& OutHit) const;
 	UFootstepDataAsset* GetFootstepData(const EPhysicalSurface SurfaceType) const;
 
+	/** Doesn't resolve or load the Data Asset, so it can be called off the game thread. */
+	const TSoftObjectPtr<UFootstepDataAsset>* FindFootstepData(const EPhysicalSurface SurfaceType) const;
+
+	void MakeTraceParams(FCollisionQueryParams& OutQueryParams, FCollisionObjectQueryParams& OutObjectParams) const;
+
+	/** Generates FX and events of a footstep with a resolved surface. If Variation is null, random choices are made here. */
+	void GenerateFootstep(const FFootstepRequest& Request, const FHitResult& HitResult, const UPhysicalMaterial* PhysMat, bool bGenerateFX, const FFootstepVariation* Variation = nullptr);
+
+	/** Generates a foot requested with bMergeSameSurface. Its sound is muted if an earlier foot of the same request has already played one on its Surface Type. */
+	void GenerateMergedFootstep(const FFootstepRequest& Request, const FHitResult& HitResult, const UPhysicalMaterial* PhysMat, bool bGenerateFX, TArray<EPhysicalSurface, TInlineAllocator<4>>& SoundSurfaces, const FFootstepVariation* Variation = nullptr);
+
+	static const UPhysicalMaterial* GetHitPhysicalMaterial(const FHitResult& HitResult);
+
 	float GetTraceLength() const;
 	bool GetShowDebug() const;
 
@@ -77,8 +177,55 @@ private:
 	UPROPERTY()
 	TArray<TObjectPtr<AActor>> ActorsToIgnore;
 
+	UPROPERTY()
+	TObjectPtr<UAudioComponent> VoiceComponent;
+
 	bool bPreloading;
 
+	FTraceDelegate AsyncTraceDelegate;
+	TArray<FFootstepPendingTrace> PendingTraces;
+	uint32 LastMergeGroup;
+
+	FTraceDelegate PreparedTraceDelegate;
+	TArray<FFootstepPreparedTrace, TInlineAllocator<2>> PreparedTraces;
+
+	/** The last Coalescing Window of every foot socket. */
+	TArray<FFootstepCoalescingWindow, TInlineAllocator<4>> CoalescingWindows;
+
+	/** Footsteps of a throttled mesh which are waiting for their place on the notify timeline, and partially weighted footsteps waiting for their Coalescing Window to close. */
+	TArray<FFootstepDelayedRequest, TInlineAllocator<2>> DelayedFootsteps;
+	FTimerHandle DelayedFootstepsTimer;
+
+	/** The frame and lateness of the first footstep of the last burst of throttled notifies. */
+	uint64 ThrottledBurstFrame;
+	float ThrottledBurstLateness;
+
+	void GetFootstepDataAssetIds(TArray<FPrimaryAssetId>& OutAssetIds) const;
+
 	void TryPreloading();
 	void CancelPreloading();
+
+	void OnAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Generates the feet of a merge group once none of its traces is pending anymore. */
+	void CompleteMergeGroup(uint32 MergeGroup);
+	void OnPreparedTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Whether the request has been taken over by the Coalescing Window of its socket. It's dropped or replaces a lighter footstep of an open window,
+	or opens a new window and waits for it to close unless it's fully weighted. */
+	bool CoalesceFootstep(const FFootstepRequest& Request);
+
+	/** Traces for the surface of a footstep which has passed coalescing and generates it. */
+	void ResolveFootstep(const FFootstepRequest& Request);
+
+	/** Whether the footstep of a throttled mesh has been delayed behind an earlier footstep from the same burst of notifies. */
+	bool DelayThrottledFootstep(const FFootstepRequest& Request);
+	void DelayFootstep(const FFootstepRequest& Request, float Delay, bool bCoalescing);
+	void ReleaseDelayedFootsteps();
+
+	/** Creates the audio component of the Footstep Voice on first use. Returns null if there's no Footstep Voice. */
+	UAudioComponent* GetVoiceComponent();
+	void PlayFootstepVoice(EPhysicalSurface SurfaceType, const FGameplayTag& Category, float Volume, float Pitch, bool bPlaySound2D);
+
+	FString GetActorName(const AActor* Actor) const;
 };
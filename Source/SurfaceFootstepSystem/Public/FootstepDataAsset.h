@@ -13,6 +13,9 @@ class USoundConcurrency;
 class UFXSystemAsset;
 class UParticleSystem;
 class UNiagaraSystem;
+class UNiagaraDataChannelAsset;
+class UStaticMesh;
+class UMaterialInterface;
 class USurfaceFootstepSystemSettings;
 
 USTRUCT()
@@ -21,25 +24,92 @@ struct FFootstepData
 	GENERATED_USTRUCT_BODY()
 
 	/** Sound will be played randomly. */
-	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Sound")
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Sound", meta = (AssetBundles = "Sound"))
 	TArray<TSoftObjectPtr<USoundBase>> Sounds;
 
-	/** A particle will be taken randomly from both Particles and Niagara Particles arrays. */
-	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Particle")
+	/** A particle will be taken randomly from both Particles and Niagara Particles arrays. Ignored if bWithCascade is False in the [SurfaceFootstepSystem] section of DefaultEngine.ini. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Particle", meta = (AssetBundles = "Particle"))
 	TArray<TSoftObjectPtr<UParticleSystem>> Particles;
 
 	/** A particle will be taken randomly from both Particles and Niagara Particles arrays. */
-	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Particle")
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Particle", meta = (AssetBundles = "Particle"))
 	TArray<TSoftObjectPtr<UNiagaraSystem>> NiagaraParticles;
+
+	/** If set, Particles and Niagara Particles are ignored and every footstep is written to this (Global) Niagara Data Channel instead of activating a Niagara Component on a Footstep Actor.
+	The channel should contain "Position" (Position), "Normal" (Vector) and "Scale" (Float) variables. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Particle|Data Channel", meta = (AssetBundles = "Particle"))
+	TSoftObjectPtr<UNiagaraDataChannelAsset> NiagaraDataChannel;
+
+	/** A Niagara System which reads footsteps from the Niagara Data Channel. Only one persistent instance of it is spawned per world, so it should use fixed bounds. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Particle|Data Channel", meta = (AssetBundles = "Particle"))
+	TSoftObjectPtr<UNiagaraSystem> NiagaraDataChannelSystem;
+
+	/** Optional footprint (for example a mesh decal). All footprints with the same mesh and material are rendered by one Instanced Static Mesh Component. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Footprint", meta = (AssetBundles = "Footprint"))
+	TSoftObjectPtr<UStaticMesh> FootprintMesh;
+
+	/** Overrides the material of the Footprint Mesh. Per Instance Custom Data 0 is the spawn time (in world seconds) and 1 is the Footprint Life Span, so the material can fade footprints out. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Footprint", meta = (AssetBundles = "Footprint"))
+	TSoftObjectPtr<UMaterialInterface> FootprintMaterial;
+
+	/** Scale of the Footprint Mesh. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Footprint")
+	FVector FootprintScale = FVector::OneVector;
 	
 	bool AreSoundsValid() const;
 };
 
+/**
+ * Cheaper footstep FX for footsteps far from every local player's view.
+ */
+USTRUCT()
+struct FFootstepLODTier
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Footsteps at least this far (in cm) from the nearest local player's view use this tier, unless a tier with a greater distance applies. */
+	UPROPERTY(EditDefaultsOnly, Category = "LOD", meta = (ClampMin = 0.f))
+	float MinDistance = 0.f;
+
+	/** If not empty, replaces the sounds of every category. */
+	UPROPERTY(EditDefaultsOnly, Category = "LOD", meta = (AssetBundles = "Sound"))
+	TArray<TSoftObjectPtr<USoundBase>> Sounds;
+
+	/** If not empty, replaces the particles of every category. */
+	UPROPERTY(EditDefaultsOnly, Category = "LOD", meta = (AssetBundles = "Particle"))
+	TArray<TSoftObjectPtr<UNiagaraSystem>> NiagaraParticles;
+
+	/** Whether footsteps of this tier should be silent. */
+	UPROPERTY(EditDefaultsOnly, Category = "LOD")
+	bool bDropSound = false;
+
+	/** Whether footsteps of this tier should spawn no particles. */
+	UPROPERTY(EditDefaultsOnly, Category = "LOD")
+	bool bDropParticles = false;
+
+	/** Whether footsteps of this tier should spawn no particles if the owner hasn't been rendered recently, for example off-screen. */
+	UPROPERTY(EditDefaultsOnly, Category = "LOD")
+	bool bDropParticlesWhenNotRendered = true;
+};
+
+/**
+ * Random choices of a single footstep. They don't load anything, so they can be made off the game thread.
+ */
+struct FFootstepVariation
+{
+	int32 SoundIndex = INDEX_NONE;
+	int32 ParticleIndex = INDEX_NONE;
+	float Volume = 1.f;
+	float Pitch = 1.f;
+	double ParticleScale = 1.0;
+};
+
 /**
  * Data asset which stores footstep audio-visual data from the Surface Footstep System plugin.
+ * It's a primary asset of the FootstepData type, with "Sound", "Particle" and "Footprint" bundles and one bundle per footstep category, named after the category tag.
  */
 UCLASS()
-class SURFACEFOOTSTEPSYSTEM_API UFootstepDataAsset : public UDataAsset
+class SURFACEFOOTSTEPSYSTEM_API UFootstepDataAsset : public UPrimaryDataAsset
 {
 	GENERATED_UCLASS_BODY()
 	
@@ -65,11 +135,11 @@ protected:
 	float MaxPitch;
 
 	/** If none, Attenuation Settings from the Sound Base will be applied. */
-	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Sound")
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Sound", meta = (AssetBundles = "Sound"))
 	TSoftObjectPtr<USoundAttenuation> AttenuationSettingsOverride;
 
 	/** If none, Concurrency Settings from the Sound Base will be applied. */
-	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Sound")
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Sound", meta = (AssetBundles = "Sound"))
 	TSoftObjectPtr<USoundConcurrency> ConcurrencySettingsOverride;
 
 	/** Minimum scale of the Particle. */
@@ -80,24 +150,76 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Particle", meta = (ClampMin = 0.0))
 	double MaxParticleScale;
 
+	/** Loudness of the noise event reported to the AI Hearing sense. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|AI", meta = (ClampMin = 0.f))
+	float NoiseLoudness;
+
+	/** Max range of the noise event reported to the AI Hearing sense. If 0, the range of the listener's Hearing config is used. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|AI", meta = (ClampMin = 0.f))
+	float NoiseMaxRange;
+
+	/** How long (in seconds) a footprint should be visible. Passed to the footprint material, which is responsible for fading. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Footprint", meta = (ClampMin = 0.f))
+	float FootprintLifeSpan;
+
 	/** The visibility time of a spawned Footstep Actor. */
 	UPROPERTY(EditDefaultsOnly, Category = "Footstep|Pooling", meta = (ClampMin = 0.f))
 	float FootstepLifeSpan;
 
+	/** Cheaper FX for distant footsteps, chosen before a Footstep Actor is taken from the pool. Footsteps closer than every tier use the full quality data. */
+	UPROPERTY(EditDefaultsOnly, Category = "Footstep|LOD")
+	TArray<FFootstepLODTier> LODTiers;
+
 public:
+	static const FPrimaryAssetType PrimaryAssetType;
+
+	//~ Begin UPrimaryDataAsset Interface
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+#if WITH_EDITORONLY_DATA
+	virtual void UpdateAssetBundleData() override;
+#endif
+	//~ End UPrimaryDataAsset Interface
+
 	void RequestLoadingAssetsAsynchronously();
 	
+	/** Thread-safe, as long as the Data Asset isn't modified at the same time. */
+	FFootstepVariation SelectVariation(const FGameplayTag& CategoryTag, FRandomStream& RandomStream) const;
+
 	USoundBase* GetSound(const FGameplayTag& CategoryTag) const;
+	USoundBase* GetSound(const FGameplayTag& CategoryTag, int32 SoundIndex) const;
 	float GetVolume() const;
 	float GetPitch() const;
 	USoundAttenuation* GetAttenuationOverride() const;
 	USoundConcurrency* GetConcurrencyOverride() const;
 
 	UFXSystemAsset* GetParticle(const FGameplayTag& CategoryTag) const;
+
+	/** The index counts Particles first and then Niagara Particles. */
+	UFXSystemAsset* GetParticle(const FGameplayTag& CategoryTag, int32 ParticleIndex) const;
+	UNiagaraDataChannelAsset* GetNiagaraDataChannel(const FGameplayTag& CategoryTag) const;
+	UNiagaraSystem* GetNiagaraDataChannelSystem(const FGameplayTag& CategoryTag) const;
 	FVector GetRelScaleParticle() const;
 
+	UStaticMesh* GetFootprintMesh(const FGameplayTag& CategoryTag) const;
+	UMaterialInterface* GetFootprintMaterial(const FGameplayTag& CategoryTag) const;
+	FVector GetFootprintScale(const FGameplayTag& CategoryTag) const;
+	float GetFootprintLifeSpan() const;
+
 	float GetFootstepLifeSpan() const;
 
+	/** Returns the tier with the greatest Min Distance within the given distance to the nearest view, or null if the full quality data should be used. */
+	const FFootstepLODTier* FindLODTier(double ViewDistanceSquared) const;
+
+	/** The LOD tier with the highest Min Distance, or null if there are no LOD tiers. */
+	const FFootstepLODTier* GetFarthestLODTier() const;
+
+	/** Picks from the tier's list, using the variation's index if it's set. */
+	USoundBase* GetLODSound(const FFootstepLODTier& LODTier, int32 SoundIndex) const;
+	UFXSystemAsset* GetLODParticle(const FFootstepLODTier& LODTier, int32 ParticleIndex) const;
+
+	float GetNoiseLoudness() const;
+	float GetNoiseMaxRange() const;
+
 private:
 	UPROPERTY()
 	TObjectPtr<USurfaceFootstepSystemSettings> FootstepSettings;
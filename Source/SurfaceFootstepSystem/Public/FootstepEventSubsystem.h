@@ -0,0 +1,100 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Perception/AISense_Hearing.h"
+#include "GameplayTagContainer.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "FootstepEventSubsystem.generated.h"
+
+class UFootstepComponent;
+
+/**
+ * A compact footstep event delivered to native listeners of the Footstep Event Subsystem.
+ */
+struct FFootstepEvent
+{
+	TWeakObjectPtr<AActor> Owner;
+	TWeakObjectPtr<UFootstepComponent> Component;
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+	FGameplayTag Category;
+	float Volume = 0.f;
+	float Pitch = 0.f;
+	double Time = 0.0;
+	TEnumAsByte<EPhysicalSurface> SurfaceType = SurfaceType_Default;
+};
+
+/** Receives all footstep events from one frame which passed the listener's filter. */
+DECLARE_DELEGATE_OneParam(FFootstepEventsDelegate, TConstArrayView<FFootstepEvent>);
+
+/**
+ * A subsystem from the Surface Footstep System plugin which delivers footstep events to gameplay systems in batches, once per frame.
+ * Unlike the Footstep Pooling Manager, it also exists on a Dedicated Server.
+ */
+UCLASS(NotBlueprintable, NotBlueprintType)
+class SURFACEFOOTSTEPSYSTEM_API UFootstepEventSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin USubsystem Interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/** Queues a noise event which will be reported to the AI Hearing sense together with all other footsteps from this frame. */
+	void AddNoiseEvent(AActor* Instigator, const FVector& Location, float Loudness, float MaxRange);
+
+	/** Queues a footstep event which will be delivered to native listeners together with all other footsteps from this frame. */
+	void AddFootstepEvent(const FFootstepEvent& FootstepEvent);
+
+	/**
+	 * Registers a native listener, which is cheaper than binding to OnFootstepGenerated of every Footstep Component.
+	 * Optionally, only footsteps of the given owner or component are delivered to it.
+	 */
+	FDelegateHandle AddFootstepEventsListener(FFootstepEventsDelegate&& Delegate, const AActor* OwnerFilter = nullptr, const UFootstepComponent* ComponentFilter = nullptr);
+	void RemoveFootstepEventsListener(FDelegateHandle Handle);
+
+	/** Returns true if footsteps of the given component should be generated even without FX, e.g. on a Dedicated Server. */
+	bool ShouldGenerateEvents(const UFootstepComponent* Component) const;
+
+	/** Returns true if any native listener would receive footsteps of the given component. */
+	bool WantsFootstepEvents(const UFootstepComponent* Component) const;
+
+	UFootstepEventSubsystem();
+
+private:
+	struct FFootstepEventsListener
+	{
+		FFootstepEventsDelegate Delegate;
+		TWeakObjectPtr<const AActor> OwnerFilter;
+		TWeakObjectPtr<const UFootstepComponent> ComponentFilter;
+		bool bFiltered = false;
+
+		/** Set when the listener unregisters while listeners are being notified. It's removed after the loop. */
+		bool bPendingRemove = false;
+
+		bool PassesFilter(const AActor* Owner, const UFootstepComponent* Component) const;
+	};
+
+	TArray<FAINoiseEvent> PendingNoiseEvents;
+	TArray<FFootstepEvent> PendingFootstepEvents;
+	TArray<FFootstepEvent> ProcessingFootstepEvents;
+	TArray<FFootstepEvent> FilteredFootstepEvents;
+	TArray<FFootstepEventsListener> Listeners;
+
+	/** Listeners registered while listeners are being notified. They're added after the loop, so Listeners isn't reallocated while a delegate executes. */
+	TArray<FFootstepEventsListener> AddedListeners;
+
+	bool bNotifyingListeners;
+
+	void FlushNoiseEvents();
+	void FlushFootstepEvents();
+};
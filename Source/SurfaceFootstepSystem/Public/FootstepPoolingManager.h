@@ -4,15 +4,182 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/StaticArray.h"
 #include "FootstepPoolingManager.generated.h"
 
 class AFootstepActor;
+class UFootstepDataAsset;
+class USurfaceFootstepSystemSettings;
+class UNiagaraComponent;
+class UNiagaraSystem;
+class UNiagaraDataChannelAsset;
+class USoundBase;
+class USoundAttenuation;
+class USoundConcurrency;
+class UFXSystemAsset;
+struct FGameplayTag;
+struct FFootstepVariation;
 
 /**
- * A subsystem from the Surface Footstep System plugin which manages Footstep Actors pooling.
+ * Footstep Actors pool metrics, measured over a sliding window.
+ */
+USTRUCT(BlueprintType)
+struct FFootstepPoolStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Amount of currently spawned Footstep Actors. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 PoolSize = 0;
+
+	/** Current maximum amount of Footstep Actors. It changes over time if Adaptive Pool Size is enabled. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 PoolLimit = 0;
+
+	/** Amount of Footstep Actors which are currently visualizing a footstep. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 ActiveActors = 0;
+
+	/** The highest amount of active Footstep Actors in the sliding window. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 HighWaterMark = 0;
+
+	/** The lowest amount of idle Footstep Actors in the sliding window. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 IdleSlots = 0;
+
+	/** Amount of Footstep Actors requested in the sliding window. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 Acquisitions = 0;
+
+	/** Amount of active Footstep Actors reused before the end of their life span in the sliding window. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 Evictions = 0;
+
+	/** Evictions per second in the sliding window. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	float EvictionRate = 0.f;
+
+	/** Amount of evictions since the pool has been created. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 TotalEvictions = 0;
+
+	/** Amount of Footstep Actors spawned since the pool has been created. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 TotalSpawned = 0;
+
+	/** Amount of idle Footstep Actors destroyed by trimming since the pool has been created. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 TotalTrimmed = 0;
+
+	/** Amount of footsteps skipped by the cull distance or the per frame limit since the pool has been created. */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Footstep System")
+	int32 TotalCulled = 0;
+};
+
+/** A single time slice of the sliding window in which the pool pressure is measured. */
+struct FFootstepPoolWindowBucket
+{
+	int32 Acquisitions = 0;
+	int32 Evictions = 0;
+	int32 HighWaterMark = 0;
+	int32 MinIdleSlots = MAX_int32;
+};
+
+/** The pool of the last torn down game world, carried over to the next one. */
+struct FFootstepPoolSnapshot
+{
+	int32 PoolSize = 0;
+	int32 PoolLimit = 0;
+};
+
+/**
+ * Keeps the Footstep Actors pool snapshot of a game instance between its worlds, so PIE instances and consecutive PIE sessions don't share it.
  */
 UCLASS(NotBlueprintable, NotBlueprintType)
-class SURFACEFOOTSTEPSYSTEM_API UFootstepPoolingManager : public UWorldSubsystem
+class SURFACEFOOTSTEPSYSTEM_API UFootstepPoolSnapshotSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	TOptional<FFootstepPoolSnapshot> Snapshot;
+};
+
+/** A scheduled deactivation of an active Footstep Actor. Stale entries are recognized by the pooling serial. */
+struct FFootstepExpiry
+{
+	double Deadline = 0.0;
+	TWeakObjectPtr<AFootstepActor> Actor;
+	uint32 PoolingSerial = 0;
+
+	bool operator<(const FFootstepExpiry& Other) const
+	{
+		return Deadline < Other.Deadline;
+	}
+};
+
+/** A footstep particle waiting to be written to a Niagara Data Channel. */
+struct FFootstepDataChannelEntry
+{
+	FVector Position;
+	FVector Normal;
+	float Scale;
+};
+
+/** Where and how the FX of a footstep are generated, apart from what comes from its Footstep Data Asset. */
+struct FFootstepFXParams
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+
+	/** Orients footprints. */
+	FVector Forward = FVector::ForwardVector;
+
+	/** Random choices made ahead, or null to make them while generating. */
+	const FFootstepVariation* Variation = nullptr;
+
+	bool bWasRecentlyRendered = true;
+	bool bPlaySound2D = false;
+
+	/** Uses the farthest LOD tier, or skips particles if there are no LOD tiers, e.g. for throttled meshes. */
+	bool bDowngrade = false;
+
+	/** Skips the sound, e.g. when another foot of the same notify plays it. */
+	bool bMuteSound = false;
+
+	/** Whether a Footstep Voice can replace the sound of the Footstep Actor. The voice is played by the caller. */
+	bool bHasVoice = false;
+};
+
+/** What has been generated for a footstep, for its events and delegates. */
+struct FFootstepFXResult
+{
+	/** The sound played by the Footstep Actor. Null if the sound has been culled as inaudible. */
+	USoundBase* Sound = nullptr;
+	UFXSystemAsset* Particle = nullptr;
+
+	FTransform Transform = FTransform::Identity;
+	FVector ParticleScale = FVector::ZeroVector;
+
+	/** Volume and pitch of the footstep, even if it's inaudible to the local listener. 0 if it has no sound. */
+	float Volume = 0.f;
+	float Pitch = 0.f;
+	float SoundAssetVolume = 0.f;
+	float SoundAssetPitch = 0.f;
+
+	/** The slot of the activated Footstep Actor, set only while Footstep tracing is enabled. */
+	int32 PoolSlot = INDEX_NONE;
+
+	/** Whether the caller should play the sound with its Footstep Voice. */
+	bool bUseVoice = false;
+};
+
+/**
+ * A subsystem from the Surface Footstep System plugin which manages Footstep Actors pooling and batched footstep particles.
+ */
+UCLASS(NotBlueprintable, NotBlueprintType)
+class SURFACEFOOTSTEPSYSTEM_API UFootstepPoolingManager : public UTickableWorldSubsystem
 {
 	GENERATED_BODY()
 
@@ -22,21 +189,121 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Surface Footstep System", meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext))
 	static void DestroyFootstepPool(const UObject* WorldContextObject);
 
+	/** Returns the Footstep Actors pool metrics, measured over the Adaptive Pool Window from the Surface Footstep System Settings. */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Surface Footstep System", meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext))
+	static FFootstepPoolStats GetFootstepPoolStats(const UObject* WorldContextObject);
+
+	/** Spawns idle Footstep Actors in one pass, up to the current pool limit, for example behind a loading screen or before streaming in a sub-level. */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Surface Footstep System", meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext))
+	static void PrewarmFootstepPool(const UObject* WorldContextObject, int32 NumActors);
+
 	//~ Begin USubsystem Interface
 	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 	//~ End USubsystem Interface
 
+	//~ Begin UWorldSubsystem Interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~ End UWorldSubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/** Whether a footstep at the given location should generate FX, according to the footstep scalability CVars. Consumes the per frame budget. */
+	bool ShouldGenerateFootstep(const FVector& Location);
+
+	/** The distance part of ShouldGenerateFootstep. Doesn't read CVars or modify anything, so it can be called off the game thread. */
+	bool IsInCullDistance(const FVector& Location, float CullDistance) const;
+
+	/** Squared distance to the nearest local player's view, or 0 if there is no view. */
+	double GetViewDistanceSquared(const FVector& Location) const;
+
+	/** The rest of ShouldGenerateFootstep, for footsteps whose distance has been checked with IsInCullDistance. */
+	bool ApplyFootstepBudget(bool bInCullDistance);
+
 	bool SafeSpawnPooledActor();
+
+	/** Returns the amount of spawned Footstep Actors. */
+	int32 PrewarmPool(int32 NumActors);
 	void DestroyPooledActors();
 	AFootstepActor* GetPooledActor(bool bRemoveInvalidActors);
 
+	/** Returns the pool slot of the actor or INDEX_NONE if it isn't pooled. */
+	int32 GetPooledActorIndex(const AFootstepActor* Actor) const;
+
+	/** Activates an initialized Footstep Actor and schedules its deactivation. If LifeSpan is 0, the actor stays active until it's reused. */
+	void ActivatePooledActor(AFootstepActor* Actor, float LifeSpan);
+
+	/** Whether a footstep sound would be heard by any listener, based on the attenuation max distance and the state of the concurrency group (as far as footsteps are concerned).
+	Called before taking a pool slot, so inaudible footsteps don't set up an Audio Component. */
+	bool CanPlayFootstepSound(USoundBase* Sound, const FVector& Location, bool bIs2D, USoundAttenuation* AttenuationOverride, USoundConcurrency* ConcurrencyOverride) const;
+
+	/** Queues a footstep particle which will be written to the Data Channel together with all other footsteps from this frame. Ensures that the reading Niagara System has a persistent instance. */
+	void AddDataChannelFootstep(UNiagaraDataChannelAsset* DataChannel, UNiagaraSystem* DataChannelSystem, const FVector& Position, const FVector& Normal, float Scale);
+
+	/** Generates the FX of a footstep of a Footstep Component or of a crowd agent. It applies LOD tiers, but ShouldGenerateFootstep has to be checked by the caller.
+	Returns false if the footstep had nothing to show. */
+	bool GenerateFootstepFX(const UFootstepDataAsset& FootstepData, const FGameplayTag& Category, const FFootstepFXParams& Params, FFootstepFXResult& OutResult);
+
+	int32 GetPoolLimit() const;
+	FFootstepPoolStats GetPoolStats() const;
+
 	UFootstepPoolingManager();
 
 protected:
 	void RemoveInvalidActors();
 
 private:
+	static constexpr int32 NumWindowBuckets = 8;
+
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<AFootstepActor>> PooledActors;
+
+	/** One persistent instance per Niagara System which reads footsteps from a Data Channel. */
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UNiagaraSystem>, TObjectPtr<UNiagaraComponent>> DataChannelComponents;
+
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UNiagaraDataChannelAsset>, int32> DataChannelIndices;
+
+	/** Footsteps from the current frame, indexed by DataChannelIndices. Arrays keep their allocations between frames. */
+	TArray<TArray<FFootstepDataChannelEntry>> PendingDataChannelEntries;
+
+	/** Min-heap of scheduled deactivations, processed in one pass per frame. */
+	TArray<FFootstepExpiry> ExpiryHeap;
+
+	TStaticArray<FFootstepPoolWindowBucket, NumWindowBuckets> WindowBuckets;
+	int32 CurrentWindowBucket;
+	double WindowBucketStartTime;
+
+	int32 PoolLimit;
+
+	int32 NumActiveActors;
+	int32 EvictionsSinceResize;
+	double LastEvictionTime;
+	double LastResizeTime;
+
+	int32 TotalEvictions;
+	int32 TotalSpawned;
+	int32 TotalTrimmed;
+	int32 TotalCulled;
+
+	int32 NumFootstepsThisFrame;
+
+	/** View locations of local players, updated every frame. */
+	TArray<FVector> ViewLocations;
+
+	AFootstepActor* SpawnPooledActor();
+
+	void ExpirePooledActors(double TimeSeconds);
+	void FlushDataChannels();
+	void DestroyDataChannelComponents();
+	void SamplePool();
+	void UpdateViewLocations();
+	void AdvanceWindow(double TimeSeconds, float WindowLength);
+	void UpdatePoolLimit(double TimeSeconds, const USurfaceFootstepSystemSettings& FootstepSettings);
+	void TrimIdleActors(int32 MaxActors);
 };
@@ -0,0 +1,78 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define FOOTSTEP_RECORDING !UE_BUILD_SHIPPING
+
+class UFootstepComponent;
+class UFootstepDataAsset;
+class USoundBase;
+class UFXSystemAsset;
+struct FFootstepRequest;
+struct FHitResult;
+
+#if FOOTSTEP_RECORDING
+
+/**
+ * A single footstep which reached the Footstep Pooling Manager, with everything needed to replay its FX side.
+ * Object names are indices into the names of the recording, or INDEX_NONE.
+ */
+struct FFootstepRecord
+{
+	double Time = 0.0;
+	uint32 Frame = 0;
+	FVector3f SocketLocation = FVector3f::ZeroVector;
+	FVector3f TraceDirection = FVector3f::ZeroVector;
+	FVector3f Location = FVector3f::ZeroVector;
+	FVector3f Normal = FVector3f::UpVector;
+	FVector3f ParticleScale = FVector3f::ZeroVector;
+	float Volume = 0.f;
+	float Pitch = 0.f;
+	int32 Category = INDEX_NONE;
+	int32 OwnerClass = INDEX_NONE;
+	int32 DataAsset = INDEX_NONE;
+	int32 Sound = INDEX_NONE;
+	int32 Particle = INDEX_NONE;
+	uint8 SurfaceType = 0;
+	bool bPlaySound2D = false;
+
+	friend FArchive& operator<<(FArchive& Ar, FFootstepRecord& Record);
+};
+
+/** Footsteps recorded during a play session, sorted by time. */
+struct FFootstepRecording
+{
+	TArray<FString> Names;
+	TArray<FFootstepRecord> Records;
+
+	/** Reads a recording file. A file cut off by a crash is read up to its last complete entry. */
+	bool Load(const FString& FilePath);
+
+	const FString* GetName(int32 Index) const;
+};
+
+/**
+ * Records footsteps to a compact binary file with Footstep.Record.Start and Footstep.Record.Stop.
+ * Only footsteps of the world in which the recording has been started are recorded, e.g. of one PIE instance.
+ * Footsteps are streamed to the file as they happen, and the file is closed when that world is cleaned up, even without Footstep.Record.Stop.
+ * The recording can be replayed without animation and physics with Footstep.Replay.
+ */
+namespace FootstepRecording
+{
+	/** Closes the file of an active recording. */
+	void Shutdown();
+
+	SURFACEFOOTSTEPSYSTEM_API bool IsRecording();
+	SURFACEFOOTSTEPSYSTEM_API void RecordFootstep(const UFootstepComponent& Component, const FFootstepRequest& Request, const FHitResult& HitResult, uint8 SurfaceType, const UFootstepDataAsset* DataAsset,
+		const USoundBase* Sound, const UFXSystemAsset* Particle, float Volume, float Pitch, const FVector& ParticleScale, bool bPlaySound2D);
+}
+
+#define FOOTSTEP_RECORD_FOOTSTEP(...) do { if (FootstepRecording::IsRecording()) { FootstepRecording::RecordFootstep(__VA_ARGS__); } } while (0)
+
+#else
+
+#define FOOTSTEP_RECORD_FOOTSTEP(...) do { } while (0)
+
+#endif
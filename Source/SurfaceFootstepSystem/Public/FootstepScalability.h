@@ -0,0 +1,37 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Footstep quality CVars from the Surface Footstep System plugin. They're set by the Quality Levels from the Surface Footstep System Settings whenever the Effects Quality changes,
+ * but they can be overridden by device profiles or the console. All values are read at runtime, so changes apply without restarting the world.
+ */
+namespace FootstepScalability
+{
+	/** Footstep.MaxPoolSize - returns INDEX_NONE if the pool size isn't limited by scalability. */
+	SURFACEFOOTSTEPSYSTEM_API int32 GetMaxPoolSize();
+
+	/** Footstep.CullDistance - returns 0 if footsteps shouldn't be culled by distance. */
+	SURFACEFOOTSTEPSYSTEM_API float GetCullDistance();
+
+	/** Footstep.SpawnParticles */
+	SURFACEFOOTSTEPSYSTEM_API bool GetSpawnParticles();
+
+	/** Footstep.MaxPerFrame - returns INDEX_NONE if the amount of footsteps per frame isn't limited. */
+	SURFACEFOOTSTEPSYSTEM_API int32 GetMaxFootstepsPerFrame();
+
+	/** Footstep.AsyncTrace */
+	SURFACEFOOTSTEPSYSTEM_API bool GetAsyncTrace();
+
+	/** Footstep.Batch - not driven by the Quality Levels. */
+	SURFACEFOOTSTEPSYSTEM_API bool GetBatch();
+
+	/** Starts applying Quality Levels when the Effects Quality changes. */
+	void Initialize();
+	void Shutdown();
+
+	/** Applies the Quality Level of the current Effects Quality, for instance after the Surface Footstep System Settings have been modified. */
+	void ApplyQualityLevel();
+}
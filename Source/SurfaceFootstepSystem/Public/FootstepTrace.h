@@ -0,0 +1,94 @@
+// Copyright Urszula Kustra. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+#define FOOTSTEP_TRACE_ENABLED UE_TRACE_ENABLED
+
+class AActor;
+struct FGameplayTag;
+
+#if FOOTSTEP_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(FootstepChannel, SURFACEFOOTSTEPSYSTEM_API);
+
+/**
+ * Footstep events for Unreal Insights, enabled with -trace=cpu,footstep. Every event and scope checks the Footstep Channel first, so nothing is traced while it's disabled.
+ */
+namespace FootstepTrace
+{
+	/** Emits a Footstep event with the result of a single footstep, and a bookmark with the same fields, so the footstep shows in the Timing Insights timeline.
+	PoolSlot is INDEX_NONE if no Footstep Actor was used. */
+	SURFACEFOOTSTEPSYSTEM_API void OutputFootstep(const AActor* Owner, uint8 SurfaceType, const FGameplayTag& Category, bool bHit, int32 PoolSlot, bool bSyncLoad);
+}
+
+#define FOOTSTEP_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, FootstepChannel)
+#define FOOTSTEP_TRACE_IS_ENABLED() UE_TRACE_CHANNELEXPR_IS_ENABLED(FootstepChannel)
+#define FOOTSTEP_TRACE_FOOTSTEP(Owner, SurfaceType, Category, bHit, PoolSlot, bSyncLoad) do { if (FOOTSTEP_TRACE_IS_ENABLED()) { FootstepTrace::OutputFootstep(Owner, SurfaceType, Category, bHit, PoolSlot, bSyncLoad); } } while (0)
+
+#else
+
+#define FOOTSTEP_TRACE_SCOPE(Name)
+#define FOOTSTEP_TRACE_IS_ENABLED() false
+#define FOOTSTEP_TRACE_FOOTSTEP(Owner, SurfaceType, Category, bHit, PoolSlot, bSyncLoad) do { } while (0)
+
+#endif
+
+#define FOOTSTEP_TRACE_SCOPES_ENABLED (FOOTSTEP_TRACE_ENABLED && CPUPROFILERTRACE_ENABLED)
+
+/**
+ * The scope of FOOTSTEP_SCOPE_CYCLE_COUNTER: a cycle counter of the Footstep stat group, which is also a timing scope of the Footstep Channel.
+ * Both live in one object, so the macro is a single declaration.
+ */
+class FFootstepScopeCounter
+{
+public:
+	template<typename SpecIdGetterType>
+	FFootstepScopeCounter(TStatId StatId, EStatFlags StatFlags, SpecIdGetterType&& GetSpecId)
+#if STATS
+		: CycleCounter(StatId, StatFlags)
+#endif
+	{
+#if FOOTSTEP_TRACE_SCOPES_ENABLED
+		bTraced = UE_TRACE_CHANNELEXPR_IS_ENABLED(CpuChannel) && FOOTSTEP_TRACE_IS_ENABLED();
+		if (bTraced)
+		{
+			FCpuProfilerTrace::OutputBeginEvent(GetSpecId());
+		}
+#endif
+	}
+
+	~FFootstepScopeCounter()
+	{
+#if FOOTSTEP_TRACE_SCOPES_ENABLED
+		if (bTraced)
+		{
+			FCpuProfilerTrace::OutputEndEvent();
+		}
+#endif
+	}
+
+private:
+#if STATS
+	FScopeCycleCounter CycleCounter;
+#endif
+#if FOOTSTEP_TRACE_SCOPES_ENABLED
+	bool bTraced = false;
+#endif
+};
+
+#if FOOTSTEP_TRACE_SCOPES_ENABLED
+#define FOOTSTEP_TRACE_SPEC_ID(Name) []() -> uint32 { static const uint32 SpecId = FCpuProfilerTrace::OutputEventType(Name, __FILE__, __LINE__); return SpecId; }
+#else
+#define FOOTSTEP_TRACE_SPEC_ID(Name) []() -> uint32 { return 0; }
+#endif
+
+#if STATS
+#define FOOTSTEP_SCOPE_CYCLE_COUNTER(Stat) FFootstepScopeCounter FootstepScope_##Stat(GET_STATID(Stat), GET_STATFLAGS(Stat), FOOTSTEP_TRACE_SPEC_ID(#Stat))
+#else
+#define FOOTSTEP_SCOPE_CYCLE_COUNTER(Stat) FFootstepScopeCounter FootstepScope_##Stat(TStatId(), EStatFlags::None, FOOTSTEP_TRACE_SPEC_ID(#Stat))
+#endif
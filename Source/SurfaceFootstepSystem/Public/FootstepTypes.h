@@ -3,5 +3,95 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "FootstepTrace.h"
+#include "FootstepAllocationGuard.h"
 
-SURFACEFOOTSTEPSYSTEM_API DECLARE_LOG_CATEGORY_EXTERN(LogFootstep, Log, All);
\ No newline at end of file
+class UAnimSequenceBase;
+
+SURFACEFOOTSTEPSYSTEM_API DECLARE_LOG_CATEGORY_EXTERN(LogFootstep, Log, All);
+
+LLM_DECLARE_TAG_API(Footstep, SURFACEFOOTSTEPSYSTEM_API);
+
+DECLARE_STATS_GROUP(TEXT("Footstep"), STATGROUP_Footstep, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Notify Total"), STAT_FootstepNotify, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Trace"), STAT_FootstepTrace, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Surface Lookup"), STAT_FootstepSurfaceLookup, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Data Asset Selection"), STAT_FootstepDataSelection, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pool Acquire"), STAT_FootstepPoolAcquire, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Actor Init"), STAT_FootstepActorInit, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sync Load"), STAT_FootstepSyncLoad, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batch"), STAT_FootstepBatch, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Footsteps"), STAT_FootstepCount, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pool Evictions"), STAT_FootstepEvictions, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Culled Footsteps"), STAT_FootstepCulled, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Sync Loads"), STAT_FootstepSyncLoads, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Async Loads In Flight"), STAT_FootstepAsyncLoads, STATGROUP_Footstep, SURFACEFOOTSTEPSYSTEM_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SURFACEFOOTSTEPSYSTEM_API, Footstep);
+
+namespace FootstepAsset
+{
+	SURFACEFOOTSTEPSYSTEM_API void OnSyncLoad();
+
+	/** Amount of synchronous loads since the module has started. */
+	SURFACEFOOTSTEPSYSTEM_API uint32 GetNumSyncLoads();
+
+	/** Resolves a soft pointer and loads the asset synchronously only if it isn't loaded yet, so real loads show up in the Sync Load stat. */
+	template<typename T>
+	T* LoadSynchronous(const TSoftObjectPtr<T>& Asset)
+	{
+		if (T* LoadedAsset = Asset.Get())
+		{
+			return LoadedAsset;
+		}
+
+		if (Asset.IsNull()) { return nullptr; }
+
+		FOOTSTEP_SCOPE_CYCLE_COUNTER(STAT_FootstepSyncLoad);
+		FOOTSTEP_ALLOCATION_GUARD_SUSPEND();
+		LLM_SCOPE_BYTAG(Footstep);
+		OnSyncLoad();
+
+		return Asset.LoadSynchronous();
+	}
+
+	/** Should be bound to every asynchronous load request of footstep assets. */
+	SURFACEFOOTSTEPSYSTEM_API void OnAsyncLoadRequested();
+	SURFACEFOOTSTEPSYSTEM_API void OnAsyncLoadCompleted();
+}
+
+/**
+ * A footstep which waits for its surface to be resolved by the Footstep Component.
+ */
+struct FFootstepRequest
+{
+	/** Has to be one of the categories from the Surface Footstep System Settings. */
+	FGameplayTag Category;
+
+	FVector TraceStart = FVector::ZeroVector;
+	FVector TraceDirection = FVector::DownVector;
+
+	/** The socket from which the trace starts. Footsteps are coalesced and prepared per socket, so requests without a socket aren't coalesced. */
+	FName SocketName;
+
+	/** The animation which requested the footstep. Used only by the debug message. */
+	TWeakObjectPtr<const UAnimSequenceBase> Animation;
+
+	/** Blend weight of the notify. Of the footsteps coalesced together, the one with the highest weight is generated. */
+	float Weight = 1.f;
+
+	/** Whether the mesh skips animation ticks because of Update Rate Optimizations or the Animation Budget Allocator. */
+	bool bThrottled = false;
+
+	/** How long ago (in seconds) the footstep should have happened. Notifies of throttled meshes are fired late and in bursts. */
+	float Lateness = 0.f;
+
+	/** Set for a foot of a multi-foot notify which has landed on the same surface as another foot, so only one of them plays a sound. */
+	bool bMuteSound = false;
+};
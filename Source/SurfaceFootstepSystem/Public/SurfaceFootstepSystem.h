@@ -16,4 +16,5 @@ private:
 	bool HandleSettingsSaved();
 	void RegisterSettings();
 	void UnregisterSettings();
+	static void RegisterPrimaryAssetType();
 };
@@ -7,6 +7,64 @@
 
 struct FGameplayTag;
 
+/**
+ * Footstep quality of a single Effects Quality level.
+ */
+USTRUCT()
+struct FFootstepQualityLevel
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Footstep.MaxPoolSize - maximum amount of Footstep Actors. If 0, only the pooling settings are used. */
+	UPROPERTY(EditDefaultsOnly, Category = "Scalability", meta = (ClampMin = 0))
+	int32 MaxPoolSize = 0;
+
+	/** Footstep.CullDistance - footsteps farther from every local player's view are skipped (except for AI noise events). If 0, footsteps aren't culled. */
+	UPROPERTY(EditDefaultsOnly, Category = "Scalability", meta = (ClampMin = 0.f))
+	float CullDistance = 0.f;
+
+	/** Footstep.SpawnParticles - whether footstep particles should be spawned. */
+	UPROPERTY(EditDefaultsOnly, Category = "Scalability")
+	bool bSpawnParticles = true;
+
+	/** Footstep.MaxPerFrame - maximum amount of footsteps with FX in a single frame. If 0, there is no limit. */
+	UPROPERTY(EditDefaultsOnly, Category = "Scalability", meta = (ClampMin = 0))
+	int32 MaxFootstepsPerFrame = 0;
+
+	/** Footstep.AsyncTrace - whether surface traces should be asynchronous. The footstep is generated in the next frame, when the trace is finished. */
+	UPROPERTY(EditDefaultsOnly, Category = "Scalability")
+	bool bAsyncTrace = false;
+};
+
+/**
+ * Names of the MetaSound inputs which receive footsteps played by a Footstep Voice.
+ */
+USTRUCT()
+struct FFootstepVoiceParameters
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Trigger executed on every footstep, after the other inputs have been set. */
+	UPROPERTY(EditDefaultsOnly, Category = "Sound")
+	FName Trigger = TEXT("OnFootstep");
+
+	/** Int32 input with the Surface Type of the footstep. */
+	UPROPERTY(EditDefaultsOnly, Category = "Sound")
+	FName SurfaceType = TEXT("SurfaceType");
+
+	/** Int32 input with the index of the footstep category in Footstep Categories. */
+	UPROPERTY(EditDefaultsOnly, Category = "Sound")
+	FName Category = TEXT("Category");
+
+	/** Float input with the volume chosen by the Footstep Data Asset. */
+	UPROPERTY(EditDefaultsOnly, Category = "Sound")
+	FName Volume = TEXT("Volume");
+
+	/** Float input with the pitch chosen by the Footstep Data Asset. */
+	UPROPERTY(EditDefaultsOnly, Category = "Sound")
+	FName Pitch = TEXT("Pitch");
+};
+
 /**
  * Editor settings for the Surface Footstep System plugin.
  */
@@ -32,14 +90,91 @@ protected:
 	UPROPERTY(config, EditDefaultsOnly, AdvancedDisplay, Category = "Trace")
 	bool bTraceComplex;
 
-	/** Maximum amount of spawned Footstep Actors. */
+	/** Notifies of the same Footstep Component and foot socket which come within this time (in seconds) are coalesced into one footstep, for example
+	when blended animations fire the same footstep. A partially weighted notify waits for the window to close, so the one with the highest weight wins,
+	but a fully weighted notify is generated right away. Keep it around a frame long, since it delays footsteps during blends. Notifies which don't trace
+	from a foot socket aren't coalesced. 0 disables coalescing. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Notify", meta = (ClampMin = 0.f))
+	float CoalescingWindow;
+
+	/** Notifies with a lower blend weight don't generate footsteps. In a blend of two animations, a value above 0.5 lets only the dominant one through.
+	The weight is known for montage notifies, other notifies are treated as fully weighted. Use the Trigger Weight Threshold of notifies in blend spaces. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Notify", meta = (ClampMin = 0.f, ClampMax = 1.f))
+	float MinNotifyWeight;
+
+	/** Whether footsteps of meshes throttled by Update Rate Optimizations or the Animation Budget Allocator should keep their spacing from the notify timeline.
+	A skipped tick fires all its notifies at once, so the first one is played right away and the others are delayed by their distance from it. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Notify|Throttling")
+	bool bResequenceThrottledFootsteps;
+
+	/** Whether footsteps of throttled meshes should use the farthest LOD tier of their Footstep Data Asset, or skip particles if it has no LOD tiers.
+	Throttled meshes are usually distant or unimportant, so this lets aggressive animation budgeting and footsteps coexist. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Notify|Throttling")
+	bool bDowngradeThrottledFootsteps;
+
+	/** Maximum amount of spawned Footstep Actors. If Adaptive Pool Size is enabled, this is the initial size and the minimum size the pool can be trimmed to. */
 	UPROPERTY(config, EditDefaultsOnly, Category = "Pooling", meta = (ClampMin = 1))
 	int32 MaxPoolSize;
 
+	/** Whether the pool should grow under pressure (when active Footstep Actors are being evicted) and trim idle Footstep Actors after a cooldown. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Pooling|Adaptive")
+	bool bAdaptivePoolSize;
+
+	/** The hard ceiling of the pool size when Adaptive Pool Size is enabled. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Pooling|Adaptive", meta = (ClampMin = 1, EditCondition = bAdaptivePoolSize))
+	int32 AdaptivePoolSizeCeiling;
+
+	/** Length (in seconds) of the sliding window in which pool pressure is measured. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Pooling|Adaptive", meta = (ClampMin = 0.1f, EditCondition = bAdaptivePoolSize))
+	float AdaptivePoolWindow;
+
+	/** How long (in seconds) the pool has to be free of evictions before idle Footstep Actors are trimmed. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Pooling|Adaptive", meta = (ClampMin = 0.f, EditCondition = bAdaptivePoolSize))
+	float AdaptivePoolTrimCooldown;
+
 	/** The default visibility time of spawned Footstep Actors. */
 	UPROPERTY(config, EditDefaultsOnly, Category = "Pooling", meta = (ClampMin = 0.f))
 	float DefaultFootstepActorLifeSpan;
 
+	/** Amount of Footstep Actors spawned in one pass when a world begins play, so the pool doesn't grow one actor at a time during gameplay. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Pooling|Prewarm", meta = (ClampMin = 0))
+	int32 PrewarmPoolSize;
+
+	/** Whether the pool size and the adapted pool limit of a world should be carried over to the next world on travel (seamless or not) and level transitions,
+	so the next world prewarms as many Footstep Actors as the previous one ended with. The pool is kept per game instance and the seamless travel transition map is skipped. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Pooling|Prewarm")
+	bool bCarryPoolAcrossTravel;
+
+	/** Whether footsteps should be reported as noise events to the AI Hearing sense. Events are sent in one batch per frame, only by the actor's authority.
+	On a Dedicated Server, footsteps run in the event-only mode: the surface is resolved, but no FX are spawned. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "AI")
+	bool bReportNoiseEvents;
+
+	/** A tag of footstep noise events. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "AI", meta = (EditCondition = bReportNoiseEvents))
+	FName NoiseEventTag;
+
+	/** Whether Footstep Data Assets should be registered in the Asset Manager as the FootstepData primary asset type, unless the Asset Manager settings already contain it.
+	Their bundles can then be loaded with Load Footstep Bundles of the Footstep Component, and the Asset Manager can assign them to chunks. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Asset Manager")
+	bool bRegisterPrimaryAssetType;
+
+	/** Directories scanned for Footstep Data Assets when the primary asset type is registered. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Asset Manager", meta = (EditCondition = bRegisterPrimaryAssetType, LongPackageName))
+	TArray<FDirectoryPath> PrimaryAssetDirectories;
+
+	/** Maximum amount of footprints per footprint mesh and material. When it's reached, the oldest footprints are recycled. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Footprint", meta = (ClampMin = 1))
+	int32 MaxFootprints;
+
+	/** Whether Quality Levels should be applied to the footstep CVars when the Effects Quality changes. Device profiles and the console can still override each CVar. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Scalability")
+	bool bApplyQualityLevels;
+
+	/** Footstep quality for every Effects Quality level (Low, Medium, High, Epic, Cinematic). */
+	UPROPERTY(config, EditDefaultsOnly, EditFixedSize, Category = "Scalability", meta = (EditCondition = bApplyQualityLevels))
+	TArray<FFootstepQualityLevel> QualityLevels;
+
 	/** Whether footstep SFX should be a 2D sound for a Local Player. If the footstep causer doesn't inherit from a Pawn class, 2D sound won't be spawned. */
 	UPROPERTY(config, EditDefaultsOnly, Category = "Sound")
 	bool bPlaySound2D_ForLocalPlayer;
@@ -52,21 +187,49 @@ protected:
 	UPROPERTY(config, EditDefaultsOnly, Category = "Sound", meta = (AllowedClasses = "/Script/Engine.SoundConcurrency"))
 	FSoftObjectPath DefaultConcurrencyOverride;
 
+	/** MetaSound inputs used by Footstep Components with a Footstep Voice. */
+	UPROPERTY(config, EditDefaultsOnly, Category = "Sound")
+	FFootstepVoiceParameters VoiceParameters;
+
 public:
 	static USurfaceFootstepSystemSettings* Get();
 
 	int32 GetCategoriesNum() const;
 	bool ContainsCategory(const FGameplayTag& CategoryTag) const;
 	FGameplayTag GetCategoryName(int32 Index) const;
+	int32 GetCategoryIndex(const FGameplayTag& CategoryTag) const;
 
 	const TArray<TEnumAsByte<ECollisionChannel>>& GetFootstepObjectTypes() const;
 	float GetDefaultTraceLength() const;
 	bool GetTraceComplex() const;
 
+	float GetCoalescingWindow() const;
+	float GetMinNotifyWeight() const;
+	bool GetResequenceThrottledFootsteps() const;
+	bool GetDowngradeThrottledFootsteps() const;
+
 	int32 GetPoolSize() const;
+	bool GetAdaptivePoolSize() const;
+	int32 GetPoolSizeCeiling() const;
+	float GetAdaptivePoolWindow() const;
+	float GetAdaptivePoolTrimCooldown() const;
 	float GetDefaultPoolingLifeSpan() const;
+	int32 GetPrewarmPoolSize() const;
+	bool GetCarryPoolAcrossTravel() const;
 	
+	bool GetReportNoiseEvents() const;
+	FName GetNoiseEventTag() const;
+
+	bool GetRegisterPrimaryAssetType() const;
+	const TArray<FDirectoryPath>& GetPrimaryAssetDirectories() const;
+
+	int32 GetMaxFootprints() const;
+
+	bool GetApplyQualityLevels() const;
+	const FFootstepQualityLevel* GetQualityLevel(int32 EffectsQuality) const;
+
 	bool GetPlaySound2D() const;
 	FString GetAttenuationAssetPath() const;
 	FString GetConcurrencyAssetPath() const;
+	const FFootstepVoiceParameters& GetVoiceParameters() const;
 };
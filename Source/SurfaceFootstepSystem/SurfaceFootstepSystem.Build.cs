@@ -1,5 +1,6 @@
 // Copyright 1998-2020 Epic Games, Inc. All Rights Reserved.
 
+using EpicGames.Core;
 using UnrealBuildTool;
 
 public class SurfaceFootstepSystem : ModuleRules
@@ -35,15 +36,35 @@ public class SurfaceFootstepSystem : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"EngineSettings",
 				"Slate",
 				"SlateCore",
                 "Niagara",
                 "GameplayTags",
-                "PhysicsCore"
+                "PhysicsCore",
+                "AIModule",
+                "Json"
             }
 			);
 		
 		
+		// Projects which use only Niagara can set bWithCascade=False in the [SurfaceFootstepSystem] section of their DefaultEngine.ini,
+		// so Footstep Actors don't create a Particle System Component and Cascade particles are ignored.
+		// It's read by the module itself, so it works with installed engines too
+		bool bWithCascade = true;
+		if (Target.ProjectFile != null)
+		{
+			ConfigHierarchy EngineConfig = ConfigCache.ReadHierarchy(ConfigHierarchyType.Engine, DirectoryReference.FromFile(Target.ProjectFile), Target.Platform);
+
+			bool bConfigWithCascade;
+			if (EngineConfig.GetBool("SurfaceFootstepSystem", "bWithCascade", out bConfigWithCascade))
+			{
+				bWithCascade = bConfigWithCascade;
+			}
+		}
+
+		PublicDefinitions.Add("SFS_WITH_CASCADE=" + (bWithCascade ? "1" : "0"));
+
 		DynamicallyLoadedModuleNames.AddRange(
 			new string[]
 			{